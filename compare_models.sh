@@ -1,60 +1,109 @@
 #!/bin/bash
-# compare_models.sh - Spustí oba modely a porovná výsledky
+# compare_models.sh - Spustí oba modely súčasne na tých istých svetoch a porovná výsledky
+#
+# Použitie: ./compare_models.sh [rozmer] [behy] [seed]
+# Behy so seedmi S..S+N-1 bežia v oboch modeloch na rovnakých svetoch:
+# každý svet sa vygeneruje raz do súboru vo WORLD_DIR a oba programy ho
+# namapujú iba na čítanie. Rozdiely behov s rovnakým seedom dávajú párový
+# t-test, ktorý rozptyl medzi svetmi odstráni.
+
+DIM=${1:-${DIM:-1000}}
+RUNS=${2:-${RUNS:-10}}
+SEED=${3:-${SEED:-1}}
+SUMMARY_FILE=${SUMMARY_FILE:-compare_summary.csv}
+if [ -z "$WORLD_DIR" ]; then
+    [ -d /dev/shm ] && WORLD_DIR=/dev/shm/kti_worlds_$$ || WORLD_DIR=${TMPDIR:-/tmp}/kti_worlds_$$
+    REMOVE_WORLD_DIR=1
+fi
+
+# Polovica jadier pre každý model; s aspoň dvoma jadrami ich pripneme zvlášť
+CORES=$(nproc 2>/dev/null || echo 1)
+HALF=$(( CORES / 2 > 0 ? CORES / 2 : 1 ))
+LIGHT_PIN=""
+HUMAN_PIN=""
+if [ "$CORES" -ge 2 ] && command -v taskset > /dev/null; then
+    LIGHT_PIN="taskset -c 0-$(( HALF - 1 ))"
+    HUMAN_PIN="taskset -c ${HALF}-$(( 2 * HALF - 1 ))"
+fi
 
 echo "=============================================="
 echo "  KOMPARATÍVNA ANALÝZA ENTROPIÍ"
 echo "  Kybernaut-Light vs Kybernaut-Human"
 echo "=============================================="
+echo "Svet ${DIM}x${DIM}, $RUNS párov behov, seed $SEED-$(( SEED + RUNS - 1 )), $HALF jadier na model"
 
-echo ""
-echo "Krok 1: Spúšťam Kybernaut-Light (fyzikálny model)..."
-echo "---------------------------------------------------"
-sleep 2
-./kybernaut_light 2>&1 | tee light_results.txt
+mkdir -p "$WORLD_DIR"
+rm -f "$SUMMARY_FILE"
 
 echo ""
-echo "Krok 2: Spúšťam Kybernaut-Human (model s učením)..."
+echo "Krok 1: Spúšťam Kybernaut-Light (fyzikálny model) a Kybernaut-Human (model s učením) súčasne..."
 echo "---------------------------------------------------"
-sleep 2
-./kybernaut_human 2>&1 | tee human_results.txt
+$LIGHT_PIN ./kybernaut_light --dim "$DIM" --seed "$SEED" --replicates "$RUNS" --threads "$HALF" \
+    --world-dir "$WORLD_DIR" --summary "$SUMMARY_FILE" > light_results.txt 2>&1 &
+light_pid=$!
+$HUMAN_PIN ./kybernaut_human --dim "$DIM" --seed "$SEED" --replicates "$RUNS" --threads "$HALF" \
+    --world-dir "$WORLD_DIR" --summary "$SUMMARY_FILE" > human_results.txt 2>&1 &
+human_pid=$!
+wait $light_pid
+light_status=$?
+wait $human_pid
+human_status=$?
+
+[ -n "$REMOVE_WORLD_DIR" ] && rm -rf "$WORLD_DIR"
+
+if [ $light_status -ne 0 ] || [ $human_status -ne 0 ]; then
+    echo "Chyba: Niektorý model skončil s chybou (light_results.txt, human_results.txt)"
+    exit 1
+fi
+echo "Hotovo."
 
 echo ""
 echo "=============================================="
 echo "  SÚHRNNÉ POROVNANIE"
 echo "=============================================="
 
-# Extrahovanie hodnôt z výsledkov
-light_delta=$(grep "Rozdiel S_thermal - S_info" light_results.txt | awk '{print $5}')
-human_delta=$(grep "Rozdiel S_thermal - S_info" human_results.txt | awk '{print $5}')
-
-light_ratio=$(grep "Pomer S_thermal/S_info" light_results.txt | awk '{print $3}')
-human_ratio=$(grep "Pomer S_thermal/S_info" human_results.txt | awk '{print $3}')
+# Priemery modelov a párové štatistiky zo súhrnu (stĺpce DeltaS=7, Ratio=8)
+eval "$(awk -F, -v test="${DIM}x${DIM}" '
+    $1 != test { next }
+    $2 == "Light" && $3 == "mean" { printf "light_delta=%s\nlight_ratio=%s\n", $7, $8 }
+    $2 == "Human" && $3 == "mean" { printf "human_delta=%s\nhuman_ratio=%s\n", $7, $8 }
+    $2 == "Light-Human" && $3 ~ /^paired_/ {
+        printf "%s_delta=%s\n%s_ratio=%s\n", $3, $7, $3, $8
+    }
+' "$SUMMARY_FILE")"
 
-light_coverage=$(grep "Pokrytie sveta" light_results.txt | grep -o "[0-9.]*%" | head -1)
-human_coverage=$(grep "Pokrytie sveta" human_results.txt | grep -o "[0-9.]*%" | head -1)
+if [ -z "$paired_t_delta" ]; then
+    echo "Chyba: V '$SUMMARY_FILE' chýba párový t-test"
+    exit 1
+fi
 
 echo ""
-echo "KLÚČOVÉ METRIKY:"
+echo "KLÚČOVÉ METRIKY (priemer z $RUNS behov):"
 echo "----------------"
-printf "%-25s %-15s %-15s\n" "METRIKA" "LIGHT (bez učenia)" "HUMAN (s učením)"
-printf "%-25s %-15s %-15s\n" "------------------------" "---------------" "---------------"
-printf "%-25s %-15s %-15s\n" "ΔS (rozdiel entropií)" "$light_delta" "$human_delta"
-printf "%-25s %-15s %-15s\n" "Pomer S_thermal/S_info" "$light_ratio" "$human_ratio"
-printf "%-25s %-15s %-15s\n" "Pokrytie sveta" "$light_coverage" "$human_coverage"
+printf "%-25s %-15s %-15s %-15s\n" "METRIKA" "LIGHT" "HUMAN" "d = L − H"
+printf "%-25s %-15s %-15s %-15s\n" "------------------------" "---------------" "---------------" "---------------"
+printf "%-25s %-15.6f %-15.6f %-15.6f\n" "ΔS (rozdiel entropií)" "$light_delta" "$human_delta" "$paired_d_delta"
+printf "%-25s %-15.6f %-15.6f %-15.6f\n" "Pomer S_thermal/S_info" "$light_ratio" "$human_ratio" "$paired_d_ratio"
+
+echo ""
+echo "PÁROVÝ T-TEST (rovnaký svet a seed, df = $paired_df_delta):"
+printf "  ΔS:    t = %.3f, p = %.3g\n" "$paired_t_delta" "$paired_p_delta"
+printf "  Pomer: t = %.3f, p = %.3g\n" "$paired_t_ratio" "$paired_p_ratio"
 
 echo ""
 echo "INTERPRETÁCIA VÝSLEDKOV:"
 echo "------------------------"
 
-if (( $(echo "$human_delta < $light_delta" | bc -l) )); then
+significant=$(awk -v p="$paired_p_delta" 'BEGIN { print (p < 0.05) ? "áno" : "nie" }')
+if awk -v h="$human_delta" -v l="$light_delta" 'BEGIN { exit !(h < l) }'; then
     echo "✓ ΔS_human < ΔS_light: Adaptívne učenie ZNIŽUJE entropickú neefektivitu"
-    efficiency_gain=$(echo "scale=2; (($light_delta - $human_delta) / $light_delta) * 100" | bc)
-    echo "  Účinnosť učenia: $efficiency_gain% zlepšenie"
+    efficiency_gain=$(awk -v h="$human_delta" -v l="$light_delta" 'BEGIN { printf "%.2f", (l - h) / l * 100 }')
+    echo "  Účinnosť učenia: $efficiency_gain% zlepšenie (štatisticky významné: $significant)"
 else
-    echo "✗ ΔS_human >= ΔS_light: Učenie NIE JE efektívnejšie ako fyzikálne zákony"
+    echo "✗ ΔS_human >= ΔS_light: Učenie NIE JE efektívnejšie ako fyzikálne zákony (štatisticky významné: $significant)"
 fi
 
-if (( $(echo "$human_ratio < $light_ratio" | bc -l) )); then
+if awk -v h="$human_ratio" -v l="$light_ratio" 'BEGIN { exit !(h < l) }'; then
     echo "✓ Pomer_human < Pomer_light: Lepšia rovnováha medzi entropiami"
 else
     echo "✗ Pomer_human >= Pomer_light: Fyzikálny model je vyrovnanejší"
@@ -65,8 +114,9 @@ echo "TEORETICKÝ ZÁVER:"
 echo "-----------------"
 echo "1. Menší ΔS znamená efektívnejšiu premenu informácie na činnosť"
 echo "2. Pomer blízky 1 znamená optimálnu rovnováhu medzi exploráciou a exploatáciou"
-echo "3. Vyššie pokrytie znamená lepšiu exploráciu prostredia"
+echo "3. Párový test porovnáva modely na tých istých svetoch, stačí menej behov"
 echo ""
 echo "Úplné výsledky v súboroch:"
 echo "  • light_results.txt"
 echo "  • human_results.txt"
+echo "  • $SUMMARY_FILE"
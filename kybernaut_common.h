@@ -0,0 +1,919 @@
+/**
+ * KYBERNAUT - spoločný kód modelov Light a Human
+ * Autor: Peter Leukanič
+ * Rok: 2026
+ *
+ * Časti, ktoré musia byť v oboch programoch rovnaké: počítadlový generátor
+ * a počiatočný svet (rovnaký seed = rovnaký svet), súbor zdieľaného sveta,
+ * výber variantov jadier podľa CPU, ukazovateľ stavu behu a vlákna, ktoré
+ * ho preberú, aréna pamäte, SIMD súčty tepelnej entropie a štatistika
+ * replikátov so súhrnom CSV. Každý program je jeden preklad, hlavičku
+ * zahrnie práve raz. Pred zahrnutím definuje model REPLICATE_MODEL,
+ * REPLICATE_PEER, REPLICATE_TITLE, REPLICATE_WELCH a REPLICATE_PAIR (smer
+ * porovnania Light − Human) a po nej dodá struct SimulationState,
+ * replicate_run a replicate_configure.
+ */
+
+#ifndef KYBERNAUT_COMMON_H
+#define KYBERNAUT_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ==================== POMOCNÉ FUNKCIE ==================== */
+
+#define INITIAL_TEMPERATURE_LEVELS 100  // Diskrétne počiatočné teploty
+
+/* Nástenný čas [s] - clock() by pri viacerých vláknach sčítal CPU čas */
+double wall_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* SplitMix64 - rýchly generátor pre nezávislé prúdy a hash buniek */
+static inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Počítadlový generátor: náhodné bity bunky sú bezstavovou funkciou
+ * (seed, riadkový index y·dimension + x), takže svet nezávisí od poradia
+ * ani počtu vlákien inicializácie a oba modely s rovnakým seedom vidia
+ * ten istý svet */
+static inline uint64_t world_cell_hash(uint64_t seed, uint64_t row) {
+    uint64_t state = seed ^ (row * 0xD6E8FEB86659FD93ULL);
+    return splitmix64(&state);
+}
+
+/* Počiatočný materiál bunky z jej náhodných bitov */
+static inline int cell_initial_material(uint64_t hash) {
+    float r = (hash % 1000) / 1000.0;
+    if (r < 0.40) return 0;       // vzduch
+    if (r < 0.70) return 1;       // voda
+    if (r < 0.90) return 2;       // sklo
+    if (r < 0.97) return 3;       // diamant
+    return 4;                     // prekážka
+}
+
+static inline int cell_initial_temperature_level(uint64_t hash) {
+    return (hash >> 32) % INITIAL_TEMPERATURE_LEVELS;
+}
+
+/* ==================== STAV BEHU ==================== */
+
+/* Stav behu definuje každý model (struct SimulationState). Kód modelu ho
+ * číta cez sim, ktorý je pre každé vlákno vlastný, takže simulácie a
+ * replikáty v rôznych vláknach sa navzájom neovplyvnia. */
+typedef struct SimulationState SimulationState;
+
+__thread SimulationState *sim __attribute__((tls_model("initial-exec")));
+
+/* Pomocné vlákno behu: pred telom prevezme stav vlákna, ktoré ho spustilo */
+typedef struct {
+    void *(*body)(void*);
+    void *arg;
+    SimulationState *state;
+} SimulationThread;
+
+void *simulation_thread_main(void *arg) {
+    SimulationThread start = *(SimulationThread*)arg;
+    free(arg);
+    sim = start.state;
+    return start.body(start.arg);
+}
+
+void simulation_thread_create(pthread_t *thread, void *(*body)(void*), void *arg) {
+    SimulationThread *start = (SimulationThread*)malloc(sizeof(SimulationThread));
+    if (!start) {
+        printf("Chyba: Nedostatok pamäte pre vlákno\n");
+        exit(1);
+    }
+    start->body = body;
+    start->arg = arg;
+    start->state = sim;
+    pthread_create(thread, NULL, simulation_thread_main, start);
+}
+
+/* ==================== VÝBER JADIER PODĽA CPU ==================== */
+
+/* Binárka sa prekladá pre základ x86-64 bez -march=native. Horúce jadrá
+ * sa preložia trikrát z jedného tela: scalar pre ľubovoľné x86-64, AVX2 a
+ * AVX-512. Ukazovatele na ne nastaví kernel_select modelu pri štarte podľa
+ * CPUID, alebo podľa voľby --kernel=. Počet pruhov jadier je pevný,
+ * varianty sa líšia iba šírkou registrov, na ktoré ho GCC rozloží. Bez
+ * kontrakcie do FMA (-ffp-contract=off) preto dávajú všetky varianty bit
+ * po bite rovnaké výsledky. */
+typedef enum {
+    KERNEL_SCALAR,
+    KERNEL_AVX2,
+    KERNEL_AVX512,
+    KERNEL_VARIANTS
+} KernelVariant;
+
+const char *kernel_names[KERNEL_VARIANTS] = {"scalar", "avx2", "avx512"};
+const int kernel_width[KERNEL_VARIANTS] = {4, 8, 16};   // Floaty v registri variantu
+KernelVariant kernel_variant = KERNEL_SCALAR;
+int kernel_forced = -1;           // --kernel=: vynútený variant, -1 = podľa CPU
+
+#define TARGET_AVX2 __attribute__((target("avx2,fma,bmi,bmi2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,bmi,bmi2,popcnt")))
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+
+/* Varianty name_scalar/_avx2/_avx512 z tela name_body a ukazovateľ name,
+ * cez ktorý sa jadro volá; telo aj jeho vektorové pomocníky musia byť
+ * KERNEL_INLINE, aby sa preložili s inštrukciami variantu */
+#define KERNEL_VARIANTS(ret, name, params, args) \
+    static ret name##_scalar params { return name##_body args; } \
+    TARGET_AVX2 static ret name##_avx2 params { return name##_body args; } \
+    TARGET_AVX512 static ret name##_avx512 params { return name##_body args; } \
+    ret (*const name##_variants[KERNEL_VARIANTS]) params = { \
+        name##_scalar, name##_avx2, name##_avx512 \
+    }; \
+    ret (*name) params = name##_scalar;
+
+/* To isté pre telo, ktoré dostane ako prvý argument šírku registra
+ * variantu vo floatoch (4, 8, 16) a podľa nej zvolí vektorový typ */
+#define KERNEL_UNPAREN(...) __VA_ARGS__
+#define KERNEL_WIDTH_VARIANTS(ret, name, params, args) \
+    static ret name##_scalar params { return name##_body(4, KERNEL_UNPAREN args); } \
+    TARGET_AVX2 static ret name##_avx2 params { return name##_body(8, KERNEL_UNPAREN args); } \
+    TARGET_AVX512 static ret name##_avx512 params { return name##_body(16, KERNEL_UNPAREN args); } \
+    ret (*const name##_variants[KERNEL_VARIANTS]) params = { \
+        name##_scalar, name##_avx2, name##_avx512 \
+    }; \
+    ret (*name) params = name##_scalar;
+
+int kernel_supported(KernelVariant variant) {
+    __builtin_cpu_init();
+    switch (variant) {
+        case KERNEL_AVX512:
+            return kernel_supported(KERNEL_AVX2) &&
+                   __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+                   __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq");
+        case KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        default:
+            return 1;
+    }
+}
+
+/* Index variantu podľa mena, -1 pre neznáme */
+int kernel_lookup(const char *name) {
+    for (int v = 0; v < KERNEL_VARIANTS; v++) {
+        if (strcmp(name, kernel_names[v]) == 0) return v;
+    }
+    return -1;
+}
+
+/* ==================== ARÉNA PAMÄTE ==================== */
+
+/* Svet modelu leží v jednej anonymnej mape zarovnanej na 2 MB, ktorú
+ * jadro môže pokryť veľkými stránkami (MADV_HUGEPAGE) - náhodný prístup
+ * potom netrpí chybami TLB. Fyzické stránky sa prideľujú až pri prvom
+ * zápise a ten robia vlákna inicializácie, takže na NUMA stroji ležia
+ * bloky sveta v uzle vlákna, ktoré ich zapísalo. Ďalší beh v tom istom
+ * procese arénu použije znova, ak mu postačuje. */
+#define ARENA_ALIGNMENT (2 * 1024 * 1024)
+
+typedef struct {
+    void *mapping;                // Celá mapa (pre munmap)
+    size_t mapping_size;
+    char *base;                   // Začiatok zarovnaný na ARENA_ALIGNMENT
+    size_t capacity;              // Použiteľné bajty od base
+    int huge_pages;               // Jadro prijalo MADV_HUGEPAGE
+    double alloc_time;            // Trvanie poslednej rezervácie [s]
+} Arena;
+
+int huge_pages_enabled = 1;       // --no-hugepages: bez MADV_HUGEPAGE (kompakcia jadra)
+
+void arena_release(Arena *a) {
+    if (a->mapping) munmap(a->mapping, a->mapping_size);
+    memset(a, 0, sizeof(*a));
+}
+
+/* Aspoň bytes bajtov z arény; NULL, ak mapa zlyhá */
+void* arena_reserve(Arena *a, size_t bytes) {
+    double start = wall_time();
+    
+    if (!a->base || a->capacity < bytes) {
+        arena_release(a);
+        
+        size_t capacity = (bytes + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+        size_t mapping_size = capacity + ARENA_ALIGNMENT;
+        void *mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) return NULL;
+        
+        a->mapping = mapping;
+        a->mapping_size = mapping_size;
+        a->base = (char*)(((uintptr_t)mapping + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+        a->capacity = capacity;
+#ifdef MADV_HUGEPAGE
+        if (huge_pages_enabled) {
+            a->huge_pages = madvise(a->base, capacity, MADV_HUGEPAGE) == 0;
+        }
+#endif
+    }
+    
+    a->alloc_time = wall_time() - start;
+    return a->base;
+}
+
+/* Rezidentná pamäť procesu [B] (0, ak /proc nie je k dispozícii) */
+size_t resident_memory() {
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    
+    unsigned long total_pages = 0, resident_pages = 0;
+    int fields = fscanf(f, "%lu %lu", &total_pages, &resident_pages);
+    fclose(f);
+    
+    return fields == 2 ? resident_pages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+/* ==================== ZDIEĽANÝ SVET ==================== */
+
+/* --world-dir D: materiál a počiatočná úroveň teploty buniek sa čítajú zo
+ * súboru D/kti_<rozmer>_<seed>.world namapovaného iba na čítanie. Súbor
+ * vygeneruje prvý proces, ktorý ho potrebuje (pod zámkom flock); ostatné
+ * procesy - Light aj Human na tom istom svete - počkajú na zámok a súbor
+ * iba namapujú, stránky zdieľajú cez page cache. Obsah: hlavička,
+ * materiály a úrovne teploty po riadkoch (y·dimension + x), 2 B na bunku.
+ * Ciele si zapíše každý model, do svojho poradia buniek (Human dlaždice)
+ * roviny prekladá inicializácia modelu. Generuje sa do súboru .world.tmp,
+ * ktorý sa hotový premenuje (rename), neúplný svet teda pod konečným
+ * menom nikdy nie je. Zvyšok prerušeného generovania prepíše ďalší proces. */
+#define WORLD_IMAGE_MAGIC "KTIWRLD1"
+#define WORLD_IMAGE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    int32_t dimension;
+    uint64_t seed;
+    uint8_t reserved[8];
+} WorldImageHeader;             // 32 B
+
+typedef struct {
+    char path[4096];
+    const uint8_t *material;    // Roviny namapovaného súboru, NULL = z hashu
+    const uint8_t *level;
+    void *mapping;
+    size_t size;
+    int generated;              // Súbor vygeneroval tento proces
+} WorldImage;
+
+const char *world_dir = NULL;   // --world-dir
+
+/* Roviny materiálov a úrovní teploty sveta (dimension, seed) do prázdneho
+ * súboru veľkosti size */
+int world_image_generate(int fd, size_t size, int32_t dimension, uint64_t seed) {
+    char *image = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (image == MAP_FAILED) return 0;
+    
+    int64_t cells = (int64_t)dimension * dimension;
+    uint8_t *material = (uint8_t*)(image + sizeof(WorldImageHeader));
+    uint8_t *level = material + cells;
+    for (int64_t row = 0; row < cells; row++) {
+        uint64_t hash = world_cell_hash(seed, row);
+        material[row] = (uint8_t)cell_initial_material(hash);
+        level[row] = (uint8_t)cell_initial_temperature_level(hash);
+    }
+    
+    WorldImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, WORLD_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = WORLD_IMAGE_VERSION;
+    header.dimension = dimension;
+    header.seed = seed;
+    memcpy(image, &header, sizeof(header));
+    
+    return munmap(image, size) == 0;
+}
+
+/* Namapuje súbor sveta (dimension, seed) z adresára dir, ak chýba,
+ * vygeneruje ho; pri chybe alebo inom obsahu ukončí program */
+void world_image_open(WorldImage *img, const char *dir, int32_t dimension, uint64_t seed) {
+    snprintf(img->path, sizeof(img->path), "%s/kti_%"PRId32"_%"PRIu64".world",
+             dir, dimension, seed);
+    img->size = sizeof(WorldImageHeader) + 2 * (size_t)dimension * dimension;
+    img->generated = 0;
+    
+    int fd = open(img->path, O_RDONLY);
+    if (fd < 0 && errno == ENOENT) {
+        // Generuje iba držiteľ zámku dočasného súboru; ďalší počkajú a svet už nájdu
+        char temp_path[sizeof(img->path) + 4];
+        snprintf(temp_path, sizeof(temp_path), "%s.tmp", img->path);
+        int temp_fd = open(temp_path, O_RDWR | O_CREAT, 0644);
+        if (temp_fd < 0 || flock(temp_fd, LOCK_EX) != 0) {
+            printf("Chyba: Súbor sveta '%s' sa nedá vytvoriť\n", temp_path);
+            exit(1);
+        }
+        
+        fd = open(img->path, O_RDONLY);
+        if (fd < 0 && errno == ENOENT) {
+            int ok = ftruncate(temp_fd, 0) == 0 && ftruncate(temp_fd, img->size) == 0 &&
+                     world_image_generate(temp_fd, img->size, dimension, seed) &&
+                     rename(temp_path, img->path) == 0;
+            if (!ok) {
+                printf("Chyba: Súbor sveta '%s' sa nepodarilo vygenerovať\n", img->path);
+                exit(1);
+            }
+            img->generated = 1;
+            fd = open(img->path, O_RDONLY);
+        } else {
+            unlink(temp_path);  // Prázdny súbor procesu, ktorý prišiel po premenovaní
+        }
+        close(temp_fd);         // Uvoľní aj zámok
+    }
+    
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        printf("Chyba: Súbor sveta '%s' sa nedá otvoriť\n", img->path);
+        exit(1);
+    }
+    void *mapping = (size_t)st.st_size == img->size ?
+                    mmap(NULL, img->size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    
+    const WorldImageHeader *header = (const WorldImageHeader*)mapping;
+    if (mapping == MAP_FAILED ||
+        memcmp(header->magic, WORLD_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != WORLD_IMAGE_VERSION ||
+        header->dimension != dimension || header->seed != seed) {
+        printf("Chyba: '%s' nie je platný súbor sveta %"PRId32"x%"PRId32" so seedom %"PRIu64"\n",
+               img->path, dimension, dimension, seed);
+        exit(1);
+    }
+    
+    img->mapping = mapping;
+    img->material = (const uint8_t*)(header + 1);
+    img->level = img->material + (size_t)dimension * dimension;
+}
+
+void world_image_close(WorldImage *img) {
+    if (img->mapping) munmap(img->mapping, img->size);
+    img->mapping = NULL;
+    img->material = NULL;
+    img->level = NULL;
+}
+
+/* ==================== REDUKCIA TEPELNÉHO POĽA (SIMD) ==================== */
+
+/* Σt a Σt·ln t teplôt v jednom prechode; tepelná entropia z nich vyjde
+ * cez -Σp·ln p = ln T - (Σt·ln t)/T, takže druhý prechod s delením odpadá.
+ * ln t je vektorová aproximácia v_log s absolútnou chybou < 1e-6. Súčty
+ * bloku idú vo float pruhoch a do double sa pripočítajú po blokoch; každé
+ * vlákno má vlastné čiastkové súčty a spoja sa v poradí vlákien.
+ *
+ * Pruhov je THERMAL_LANES a prvok i patrí vždy pruhu i mod THERMAL_LANES,
+ * takže súčty sú vo všetkých variantoch rovnaké. Variant ich drží vo
+ * vektoroch šírky svojho registra: vektory širšie ako register GCC 12
+ * rozkladá zle (porovnania po prvkoch, akumulátory cez pamäť), telo sa
+ * preto generuje makrom THERMAL_SUMS pre šírky 4, 8 a 16. Ktoré teploty
+ * tvoria blok, určuje vlákno redukcie modelu. */
+#define THERMAL_LANES 16
+#define BENCH_ENTROPY_REPEATS 5
+
+/* v_greater: maska x > y zo znamienka y - x (rozdiel dvoch rôznych
+ * konečných floatov nie je nikdy nula), bez vektorového porovnania.
+ * v_log: ln x pre x > 0; x = m·2^e s m ∈ [√½, √2), ln m = 2·atanh(s)
+ * pre s = (m-1)/(m+1), |s| < 0.172; rad do s⁹ má chybu < 1e-9.
+ * thermal_block_sums: pripočíta Σt a Σt·ln t bloku count prvkov;
+ * prvky t ≤ 0 prispievajú nulou. */
+#define THERMAL_SUMS(W) \
+typedef float tfloat##W __attribute__((vector_size(W * sizeof(float)))); \
+typedef int32_t tint##W __attribute__((vector_size(W * sizeof(int32_t)))); \
+ \
+KERNEL_INLINE tint##W v_greater##W(tfloat##W x, tfloat##W y) { \
+    return (tint##W)(y - x) >> 31; \
+} \
+ \
+KERNEL_INLINE tfloat##W v_select##W(tint##W mask, tfloat##W a, tfloat##W b) { \
+    return (tfloat##W)(((tint##W)a & mask) | ((tint##W)b & ~mask)); \
+} \
+ \
+KERNEL_INLINE tfloat##W v_log##W(tfloat##W x) { \
+    tint##W bits = (tint##W)x; \
+    tint##W e = ((bits >> 23) & 0xFF) - 127; \
+    tfloat##W m = (tfloat##W)((bits & 0x007FFFFF) | 0x3F800000); \
+    tint##W high = v_greater##W(m, (tfloat##W){} + 1.41421356f); \
+    m = v_select##W(high, 0.5f * m, m); \
+    e = e - high;                   /* high je -1 tam, kde sa m polovilo */ \
+    \
+    tfloat##W s = (m - 1.0f) / (m + 1.0f); \
+    tfloat##W s2 = s * s; \
+    tfloat##W p = (tfloat##W){} + 1.0f/9; \
+    p = p * s2 + 1.0f/7; \
+    p = p * s2 + 1.0f/5; \
+    p = p * s2 + 1.0f/3; \
+    p = p * s2 + 1.0f; \
+    return 2.0f * s * p + __builtin_convertvector(e, tfloat##W) * 0.69314718f; \
+} \
+ \
+KERNEL_INLINE void thermal_block_sums##W(const float *t, int64_t count, \
+                                         double *sum, double *xlogx_sum) { \
+    tfloat##W vs[THERMAL_LANES / W] = {{0}}, vx[THERMAL_LANES / W] = {{0}}; \
+    int64_t i = 0; \
+    \
+    for (; i + THERMAL_LANES <= count; i += THERMAL_LANES) { \
+        for (int k = 0; k < THERMAL_LANES / W; k++) { \
+            tfloat##W v; \
+            memcpy(&v, t + i + k * W, sizeof(v)); \
+            tint##W positive = v_greater##W(v, (tfloat##W){}); \
+            tfloat##W safe = v_select##W(positive, v, (tfloat##W){} + 1.0f); \
+            vs[k] += v_select##W(positive, v, (tfloat##W){}); \
+            vx[k] += v_select##W(positive, v * v_log##W(safe), (tfloat##W){}); \
+        } \
+    } \
+    \
+    double s = 0.0, x = 0.0; \
+    for (int l = 0; l < THERMAL_LANES; l++) { \
+        s += vs[l / W][l % W]; \
+        x += vx[l / W][l % W]; \
+    } \
+    for (; i < count; i++) { \
+        if (t[i] > 0.0f) { \
+            s += t[i]; \
+            x += t[i] * log(t[i]); \
+        } \
+    } \
+    *sum += s; \
+    *xlogx_sum += x; \
+}
+
+THERMAL_SUMS(4)
+THERMAL_SUMS(8)
+THERMAL_SUMS(16)
+
+/* Súčty bloku count teplôt vo variante šírky width */
+KERNEL_INLINE void thermal_block_sums(int width, const float *t, int64_t count,
+                                      double *sum, double *xlogx_sum) {
+    if (width == 16) thermal_block_sums16(t, count, sum, xlogx_sum);
+    else if (width == 8) thermal_block_sums8(t, count, sum, xlogx_sum);
+    else thermal_block_sums4(t, count, sum, xlogx_sum);
+}
+
+/* Vlákno redukcie: bloky first + k·stride (význam bloku určuje model) */
+typedef struct {
+    pthread_t thread;
+    int64_t first, stride;
+    double sum, xlogx_sum;
+} ThermalWorker;
+
+/* Spustí threads vlákien worker, spojí ich súčty v poradí vlákien a vráti
+ * tepelnú entropiu cells buniek normovanú na ln(cells) */
+float thermal_entropy_reduce(void *(*worker)(void*), int32_t threads, double cells) {
+    ThermalWorker *workers = (ThermalWorker*)calloc(threads, sizeof(ThermalWorker));
+    if (!workers) {
+        printf("Chyba: Nedostatok pamäte pre redukciu teplôt\n");
+        exit(1);
+    }
+    
+    for (int32_t t = 0; t < threads; t++) {
+        workers[t].first = t;
+        workers[t].stride = threads;
+        simulation_thread_create(&workers[t].thread, worker, &workers[t]);
+    }
+    double T = 0.0, X = 0.0;
+    for (int32_t t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        T += workers[t].sum;
+        X += workers[t].xlogx_sum;
+    }
+    free(workers);
+    
+    if (T <= 0.0) return 0.0;
+    
+    double entropy = log(T) - X / T;
+    double max_entropy = log(cells);
+    if (max_entropy > 0.0) {
+        entropy /= max_entropy;
+    }
+    
+    if (entropy < 0.0) entropy = 0.0;
+    if (entropy > 1.0) entropy = 1.0;
+    
+    return entropy;
+}
+
+/* ==================== REPLIKÁTY A ŠTATISTIKA ==================== */
+
+/* --replicates N spustí N behov so seedmi S, S+1, ..., S+N-1 v jednom
+ * spustení programu namiesto N procesov, ktorých výpis treba parsovať.
+ * Behy idú súbežne v T vláknach procesu. Vlákno t má vlastný stav behu
+ * (kópiu nastavení programu, bez výpisu), počíta replikáty t, t+T, ...
+ * a svoju arénu sveta použije pre všetky z nich. Metriky zapíše do poľa
+ * výsledkov na index replikátu. Priemer a rozptyl ráta hlavné vlákno
+ * Welfordovým algoritmom v poradí replikátov, takže nezávisia od T.
+ * Replikát r sa dá zopakovať samostatne cez --seed S+r.
+ * V súhrne CSV sa prepíšu riadky tohto modelu pre daný svet. Ak súbor
+ * obsahuje behy druhého modelu na rovnako veľkom svete, pribudne Welchov
+ * t-test rozdielu Light − Human (rovnaký v oboch programoch). Behy oboch
+ * modelov s rovnakým seedom prebehli na tom istom svete; z ich rozdielov
+ * pribudne aj párový t-test, ktorý rozptyl medzi svetmi odstráni.
+ * Zápis súhrnu drží zámok flock, oba programy môžu bežať súčasne. */
+#define REPLICATE_COMPARISON "Light-Human"
+#define REPLICATE_LINE_MAX 1024
+
+enum { REP_S_INFO, REP_S_THERMAL, REP_S_QUANTUM, REP_DELTA_S, REP_RATIO, REP_METRICS };
+
+const char *replicate_metric_names[REP_METRICS] = {"S_info", "S_thermal", "S_quantum", "ΔS", "Pomer"};
+
+typedef struct {
+    uint64_t seed;
+    double value[REP_METRICS];
+    double time;                  // Čas simulácie [s]
+    int done;                     // Vlákno replikát dokončilo
+} ReplicateResult;
+
+/* Welfordov priebežný priemer a súčet štvorcov odchýlok */
+typedef struct {
+    int64_t n;
+    double mean;
+    double m2;
+} RunningStats;
+
+int32_t replicate_count = 0;      // --replicates: 0 = jeden beh s výpisom
+const char *replicate_summary = "summary.csv";  // --summary
+
+/* Dodá model: jeden replikát so seedom bez výpisu do r v stave sim,
+ * príprava behu workers súbežných replikátov z threads vlákien (doplní aj
+ * riadok ohlásenia replikátov) a stav vlákna replikátov - kópia stavu
+ * programu pred prvým svetom - s jeho uvoľnením */
+void replicate_run(uint64_t seed, ReplicateResult *r);
+void replicate_configure(int32_t threads, int32_t workers);
+SimulationState *replicate_state_create();
+void replicate_state_destroy(SimulationState *state);
+
+void stats_add(RunningStats *s, double x) {
+    s->n++;
+    double delta = x - s->mean;
+    s->mean += delta / s->n;
+    s->m2 += delta * (x - s->mean);
+}
+
+/* Výberový rozptyl (delenie n-1) */
+double stats_variance(const RunningStats *s) {
+    return s->n > 1 ? s->m2 / (s->n - 1) : 0.0;
+}
+
+static inline double lentz_clamp(double v) {
+    return fabs(v) < 1e-300 ? 1e-300 : v;
+}
+
+/* Regularizovaná neúplná beta I_x(a,b) cez reťazový zlomok (Lentz) */
+double incomplete_beta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    if (x > (a + 1.0) / (a + b + 2.0)) return 1.0 - incomplete_beta(b, a, 1.0 - x);
+    
+    double c = 1.0;
+    double d = 1.0 / lentz_clamp(1.0 - (a + b) * x / (a + 1.0));
+    double f = d;
+    for (int m = 1; m <= 300; m++) {
+        double even = m * (b - m) * x / ((a + 2 * m - 1.0) * (a + 2 * m));
+        d = 1.0 / lentz_clamp(1.0 + even * d);
+        c = lentz_clamp(1.0 + even / c);
+        f *= c * d;
+        
+        double odd = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1.0));
+        d = 1.0 / lentz_clamp(1.0 + odd * d);
+        c = lentz_clamp(1.0 + odd / c);
+        double delta = c * d;
+        f *= delta;
+        if (fabs(delta - 1.0) < 1e-12) break;
+    }
+    
+    double log_front = lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log1p(-x);
+    return exp(log_front) * f / a;
+}
+
+/* Welchov t-test rozdielu priemerov a − b (obe n ≥ 2): t, stupne voľnosti
+ * a obojstranné p zo Studentovho rozdelenia */
+void welch_test(const RunningStats *a, const RunningStats *b, double *t, double *df, double *p) {
+    double va = stats_variance(a) / a->n;
+    double vb = stats_variance(b) / b->n;
+    double diff = a->mean - b->mean;
+    
+    if (va + vb <= 0.0) {
+        *t = diff == 0.0 ? 0.0 : copysign(INFINITY, diff);
+        *df = a->n + b->n - 2;
+        *p = diff == 0.0 ? 1.0 : 0.0;
+        return;
+    }
+    
+    *t = diff / sqrt(va + vb);
+    *df = (va + vb) * (va + vb) / (va * va / (a->n - 1) + vb * vb / (b->n - 1));
+    *p = incomplete_beta(*df / 2.0, 0.5, *df / (*df + *t * *t));
+}
+
+/* Párový t-test: d sú rozdiely dvojíc behov (n ≥ 2), t, df = n − 1 a
+ * obojstranné p ako vo welch_test */
+void paired_test(const RunningStats *d, double *t, double *df, double *p) {
+    double v = stats_variance(d) / d->n;
+    *df = d->n - 1;
+    
+    if (v <= 0.0) {
+        *t = d->mean == 0.0 ? 0.0 : copysign(INFINITY, d->mean);
+        *p = d->mean == 0.0 ? 1.0 : 0.0;
+        return;
+    }
+    
+    *t = d->mean / sqrt(v);
+    *p = incomplete_beta(*df / 2.0, 0.5, *df / (*df + *t * *t));
+}
+
+/* Entropie skončeného behu do výsledku replikátu */
+void replicate_record(ReplicateResult *r, uint64_t seed,
+                      double information, double thermal, double quantum) {
+    r->seed = seed;
+    r->value[REP_S_INFO] = information;
+    r->value[REP_S_THERMAL] = thermal;
+    r->value[REP_S_QUANTUM] = quantum;
+    r->value[REP_DELTA_S] = thermal - information;
+    r->value[REP_RATIO] = information > 0 ? thermal / information : 0;
+}
+
+/* Rozdelí riadok CSV na mieste; vráti počet polí */
+int csv_split(char *line, char **fields, int max_fields) {
+    int count = 0;
+    while (count < max_fields) {
+        fields[count++] = line;
+        line = strchr(line, ',');
+        if (!line) break;
+        *line++ = '\0';
+    }
+    return count;
+}
+
+/* Pole Run s číslom behu (nie mean, variance, t, ...) */
+static inline int csv_is_run(const char *field) {
+    if (!*field) return 0;
+    for (; *field; field++) {
+        if (*field < '0' || *field > '9') return 0;
+    }
+    return 1;
+}
+
+/* Prepíše riadky modelu pre svet test v súhrne a doplní štatistiku druhého
+ * modelu z behov, ktoré v súbore už sú (peer[m].n = 0, ak žiadne nie sú),
+ * a rozdiely Light − Human behov s rovnakým seedom do paired.
+ * Vráti 0, ak súbor nemožno zapísať. */
+int replicate_write_summary(const char *test, const ReplicateResult *results,
+                            const RunningStats *stats, RunningStats *peer, RunningStats *paired) {
+    // Druhý model môže súhrn práve prepisovať
+    int lock = open(replicate_summary, O_RDWR | O_CREAT, 0644);
+    if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+        if (lock >= 0) close(lock);
+        return 0;
+    }
+
+    char *old = NULL;
+    FILE *f = fopen(replicate_summary, "r");
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        old = (char*)malloc(size > 0 ? size + 1 : 1);
+        if (!old) {
+            fclose(f);
+            close(lock);
+            return 0;
+        }
+        old[fread(old, 1, size > 0 ? size : 0, f)] = '\0';
+        fclose(f);
+    }
+
+    f = fopen(replicate_summary, "w");
+    if (!f) {
+        free(old);
+        close(lock);
+        return 0;
+    }
+    fprintf(f, "Test,Model,Run,S_info,S_thermal,S_quantum,DeltaS,Ratio,Seed\n");
+
+    // Riadky iných svetov a druhého modelu zostanú, vlastné a porovnanie sa prepíšu
+    for (char *line = old, *next; line && *line; line = next) {
+        next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        char copy[REPLICATE_LINE_MAX];
+        snprintf(copy, sizeof(copy), "%s", line);
+        char *fields[3 + REP_METRICS + 1] = {0};
+        int count = csv_split(copy, fields, 3 + REP_METRICS + 1);
+        if (count < 3 || strcmp(fields[0], "Test") == 0) continue;
+
+        if (strcmp(fields[0], test) == 0) {
+            if (strcmp(fields[1], REPLICATE_MODEL) == 0 ||
+                strcmp(fields[1], REPLICATE_COMPARISON) == 0) continue;
+            if (strcmp(fields[1], REPLICATE_PEER) == 0 && csv_is_run(fields[2]) &&
+                count >= 3 + REP_METRICS) {
+                // Seed je posledné pole, rozdiel voči vlastnému behu na tom istom svete
+                uint64_t r = count > 3 + REP_METRICS ?
+                             strtoull(fields[3 + REP_METRICS], NULL, 10) - results[0].seed :
+                             UINT64_MAX;
+                for (int m = 0; m < REP_METRICS; m++) {
+                    double value = strtod(fields[3 + m], NULL);
+                    stats_add(&peer[m], value);
+                    if (r < (uint64_t)replicate_count) {
+                        stats_add(&paired[m], REPLICATE_PAIR(results[r].value[m], value));
+                    }
+                }
+            }
+        }
+        fprintf(f, "%s\n", line);
+    }
+    free(old);
+
+    for (int32_t r = 0; r < replicate_count; r++) {
+        fprintf(f, "%s,%s,%"PRId32, test, REPLICATE_MODEL, r + 1);
+        for (int m = 0; m < REP_METRICS; m++) fprintf(f, ",%.9g", results[r].value[m]);
+        fprintf(f, ",%"PRIu64"\n", results[r].seed);
+    }
+    fprintf(f, "%s,%s,mean", test, REPLICATE_MODEL);
+    for (int m = 0; m < REP_METRICS; m++) fprintf(f, ",%.9g", stats[m].mean);
+    fprintf(f, ",\n%s,%s,variance", test, REPLICATE_MODEL);
+    for (int m = 0; m < REP_METRICS; m++) fprintf(f, ",%.9g", stats_variance(&stats[m]));
+    fprintf(f, ",\n");
+
+    if (peer[REP_S_INFO].n >= 2) {
+        double t[REP_METRICS], df[REP_METRICS], p[REP_METRICS];
+        for (int m = 0; m < REP_METRICS; m++) {
+            REPLICATE_WELCH(&stats[m], &peer[m], &t[m], &df[m], &p[m]);
+        }
+        const char *rows[3] = {"t", "df", "p"};
+        const double *values[3] = {t, df, p};
+        for (int row = 0; row < 3; row++) {
+            fprintf(f, "%s,%s,%s", test, REPLICATE_COMPARISON, rows[row]);
+            for (int m = 0; m < REP_METRICS; m++) fprintf(f, ",%.9g", values[row][m]);
+            fprintf(f, ",\n");
+        }
+    }
+
+    if (paired[REP_S_INFO].n >= 2) {
+        double d[REP_METRICS], t[REP_METRICS], df[REP_METRICS], p[REP_METRICS];
+        for (int m = 0; m < REP_METRICS; m++) {
+            d[m] = paired[m].mean;
+            paired_test(&paired[m], &t[m], &df[m], &p[m]);
+        }
+        const char *rows[4] = {"paired_d", "paired_t", "paired_df", "paired_p"};
+        const double *values[4] = {d, t, df, p};
+        for (int row = 0; row < 4; row++) {
+            fprintf(f, "%s,%s,%s", test, REPLICATE_COMPARISON, rows[row]);
+            for (int m = 0; m < REP_METRICS; m++) fprintf(f, ",%.9g", values[row][m]);
+            fprintf(f, ",\n");
+        }
+    }
+
+    int written = fclose(f) == 0;
+    close(lock);
+    return written;
+}
+
+/* Vlákno replikátov: replikáty first, first + stride, ... vo vlastnom stave */
+typedef struct {
+    pthread_t thread;
+    int32_t first, stride;
+    uint64_t base_seed;
+    ReplicateResult *results;
+    SimulationState *state;
+} ReplicateWorker;
+
+void *replicate_worker(void *arg) {
+    ReplicateWorker *w = (ReplicateWorker*)arg;
+    sim = w->state;
+    for (int32_t r = w->first; r < replicate_count; r += w->stride) {
+        replicate_run(w->base_seed + r, &w->results[r]);
+        w->results[r].done = 1;
+    }
+    return NULL;
+}
+
+/* Replikáty na svete dimension vo workers vláknach, súhrn na výstup a do
+ * CSV; vráti kód ukončenia */
+int run_replicates(uint64_t base_seed, int32_t workers, int32_t dimension) {
+    int32_t threads = workers;
+    if (workers > replicate_count) workers = replicate_count;
+    
+    ReplicateResult *results = (ReplicateResult*)calloc(replicate_count, sizeof(ReplicateResult));
+    ReplicateWorker *pool = (ReplicateWorker*)calloc(workers, sizeof(ReplicateWorker));
+    if (!results || !pool) {
+        printf("Chyba: Nedostatok pamäte pre výsledky replikátov\n");
+        return 1;
+    }
+    
+    printf("Replikáty: %"PRId32" behov na svete %"PRId32"x%"PRId32", seed %"PRIu64"-%"PRIu64", %"PRId32" vlákien",
+           replicate_count, dimension, dimension, base_seed, base_seed + replicate_count - 1, workers);
+    replicate_configure(threads, workers);
+    printf("...\n");
+    fflush(stdout);
+    
+    double start = wall_time();
+    int32_t started = 0;
+    for (; started < workers; started++) {
+        ReplicateWorker *w = &pool[started];
+        w->first = started;
+        w->stride = workers;
+        w->base_seed = base_seed;
+        w->results = results;
+        w->state = replicate_state_create();
+        if (pthread_create(&w->thread, NULL, replicate_worker, w) != 0) {
+            printf("Chyba: Vlákno replikátov %"PRId32" sa nepodarilo spustiť\n", started);
+            replicate_state_destroy(w->state);
+            break;
+        }
+    }
+    for (int32_t t = 0; t < started; t++) {
+        pthread_join(pool[t].thread, NULL);
+        replicate_state_destroy(pool[t].state);
+    }
+    free(pool);
+    double total_time = wall_time() - start;
+    
+    RunningStats stats[REP_METRICS] = {{0}};
+    int failed = 0;
+    printf("\nREPLIKÁTY KYBERNAUT-%s (n=%"PRId32", svet %"PRId32"x%"PRId32"):\n",
+           REPLICATE_TITLE, replicate_count, dimension, dimension);
+    for (int32_t r = 0; r < replicate_count; r++) {
+        if (!results[r].done) {
+            printf("  [%3"PRId32"] seed %"PRIu64": beh nedobehol\n", r + 1, base_seed + r);
+            failed = 1;
+            continue;
+        }
+        for (int m = 0; m < REP_METRICS; m++) stats_add(&stats[m], results[r].value[m]);
+        printf("  [%3"PRId32"] seed %"PRIu64": S_info=%.4f S_thermal=%.4f S_quantum=%.4f ΔS=%.4f Pomer=%.3f (%.3f s)\n",
+               r + 1, results[r].seed, results[r].value[REP_S_INFO], results[r].value[REP_S_THERMAL],
+               results[r].value[REP_S_QUANTUM], results[r].value[REP_DELTA_S],
+               results[r].value[REP_RATIO], results[r].time);
+    }
+    if (failed) {
+        printf("Chyba: Niektoré replikáty nedobehli, súhrn sa neukladá.\n");
+        free(results);
+        return 1;
+    }
+    
+    printf("\nŠTATISTIKA (priemer ± výberová smerodajná odchýlka):\n");
+    for (int m = 0; m < REP_METRICS; m++) {
+        printf("  %s: %.6f ± %.6f\n", replicate_metric_names[m],
+               stats[m].mean, sqrt(stats_variance(&stats[m])));
+    }
+    printf("  Čas: %.3f s (%"PRId32" vlákien, %.3f s na replikát)\n",
+           total_time, workers, total_time * workers / replicate_count);
+    
+    char test[32];
+    snprintf(test, sizeof(test), "%"PRId32"x%"PRId32, dimension, dimension);
+    RunningStats peer[REP_METRICS] = {{0}};
+    RunningStats paired[REP_METRICS] = {{0}};
+    if (!replicate_write_summary(test, results, stats, peer, paired)) {
+        printf("Chyba: Súhrn sa nepodarilo zapísať do '%s'\n", replicate_summary);
+        free(results);
+        return 1;
+    }
+    
+    if (peer[REP_S_INFO].n >= 2) {
+        printf("\nWELCHOV T-TEST Light − Human (%s n=%"PRId64", %s n=%"PRId64"):\n",
+               REPLICATE_MODEL, stats[REP_S_INFO].n, REPLICATE_PEER, peer[REP_S_INFO].n);
+        for (int m = 0; m < REP_METRICS; m++) {
+            double t, df, p;
+            REPLICATE_WELCH(&stats[m], &peer[m], &t, &df, &p);
+            printf("  %s: t=%.3f, df=%.1f, p=%.3g%s\n", replicate_metric_names[m], t, df, p,
+                   p < 0.05 ? " (významný, p < 0.05)" : "");
+        }
+    } else {
+        printf("\nT-test: v '%s' zatiaľ nie sú behy %s na svete %s\n",
+               replicate_summary, REPLICATE_PEER, test);
+    }
+    if (paired[REP_S_INFO].n >= 2) {
+        printf("\nPÁROVÝ T-TEST Light − Human (%"PRId64" dvojíc s rovnakým seedom a svetom):\n",
+               paired[REP_S_INFO].n);
+        for (int m = 0; m < REP_METRICS; m++) {
+            double t, df, p;
+            paired_test(&paired[m], &t, &df, &p);
+            printf("  %s: d=%.6f ± %.6f, t=%.3f, df=%.0f, p=%.3g%s\n", replicate_metric_names[m],
+                   paired[m].mean, sqrt(stats_variance(&paired[m])), t, df, p,
+                   p < 0.05 ? " (významný, p < 0.05)" : "");
+        }
+    }
+    printf("Súhrn uložený do: %s\n", replicate_summary);
+    
+    free(results);
+    return 0;
+}
+
+#endif /* KYBERNAUT_COMMON_H */
@@ -24,6 +24,26 @@
  * OPRAVENÉ CHYBY:
  * - Odstránené nepoužité premenné
  * - Pridané chýbajúce deklarácie
+ *
+ * VÝKONNOSTNÉ ÚPRAVY:
+ * - Počítadlový generátor (seed, bunka) a paralelná inicializácia sveta
+ * - Svet a pamäť v jednej aréne (mmap, veľké stránky, paralelný prvý dotyk)
+ * - Lenivé chladenie buniek podľa epochy posledného ochladenia
+ * - Pamäť Q bez zámkov buniek (atomické čítanie a compare-and-swap)
+ * - Paralelný plánovač s rolloutmi hĺbky MEMORY_DEPTH (--lookahead)
+ * - Hogwild učenie K agentov nad zdieľanou pamäťou Q (--agents)
+ * - Prioritizované zametanie vo vlákne na pozadí (--sweeping)
+ * - Q-hodnoty predvyplnené z poľa ceny k cieľom (--cost-to-go)
+ * - Lineárna aproximácia Q s pevnou pamäťou namiesto tabuľky (--linear)
+ * - Riedky snapshot pamäte Q a teplý štart cez mmap (--save-q, --load-q)
+ * - Horúce polia a Q-hodnoty v 32 B bunke (16 B pri --linear), dlaždice v Z-poradí
+ * - Pokrytie, kvantová entropia a priemerná teplota priebežne bez skenov
+ * - Paralelné SIMD jadro tepelnej entropie v jednom prechode poľom
+ * - Prenosná binárka: varianty jadier scalar/AVX2/AVX-512 vybrané pri štarte
+ * - Replikáty v súbežných vláknach s Welfordovou štatistikou a t-testom
+ * - Zdieľaný svet s Kybernaut-Light (mmap súboru, --world-dir) a párový t-test
+ * - Tichý režim (--quiet) a knižnica s rozhraním create/step/metrics/destroy (kybernaut_human.h)
+ * - Stav behu v štruktúre (SimulationState), simulácie knižnice súbežne vo vláknach
  */
 
 #include <stdio.h>
@@ -33,12 +53,32 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 #include <inttypes.h>  // PRIDANÉ: Pre veľké mriežky
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
+#include "kybernaut_human.h"
+
+// Súhrn replikátov: riadky Human a porovnanie Light − Human
+#define REPLICATE_MODEL "Human"
+#define REPLICATE_PEER "Light"
+#define REPLICATE_TITLE "HUMAN"
+#define REPLICATE_WELCH(own, peer, t, df, p) welch_test(peer, own, t, df, p)
+#define REPLICATE_PAIR(own, peer) ((peer) - (own))
+#include "kybernaut_common.h"
 
 #define MAX_STEPS 30000           // ZVÝŠENÉ pre veľké mriežky
 #define NUM_THREADS 4
 #define MEMORY_DEPTH 6
 #define LOG_FILENAME "kybernaut_human_v3.1_log.txt"
+#define INIT_BLOCK_COLUMNS 16     // Stĺpce x v jednom bloku inicializácie (násobok TILE_SIDE)
+#define COOLING_INTERVAL 100      // Kroky medzi ochladeniami sveta
+#define COOLING_EPOCHS (MAX_STEPS / COOLING_INTERVAL + 1)
+#define TILE_BITS 3               // Dlaždica 8×8 buniek (1 KB) v Z-poradí
+#define TILE_SIDE (1 << TILE_BITS)
 
 /* ==================== FYZIKÁLNE KONŠTANTY A PROJEKCIA ==================== */
 
@@ -71,27 +111,46 @@ Material materials[5] = {
     {10.0,  5.0e-1,  1.0e6,  5000.0, 2.0e11, "prekazka", 'X'}
 };
 
+/* Krok agenta číta a píše polia bunky Cell: návštevy, teplotu,
+ * informačnú hustotu a materiál, v tabuľkovom režime aj Q-hodnoty.
+ * Tabuľkový režim preto ukladá bunku FusedCell s Q-hodnotami a poľami
+ * Cell v jednom 32 B zázname, polovici riadku cache. Pri --linear sa
+ * Q-hodnoty neukladajú a záznam je iba 16 B Cell. Zvyšné polia sveta
+ * (Node) a štatistika pamäte (MemoryNode, nie pri --linear) ležia
+ * v samostatných poliach s rovnakým indexom cell_index(x, y). */
 typedef struct {
-    int32_t x, y;               // PRIDANÉ: int32_t
     int32_t visits;             // PRIDANÉ: int32_t
     float temperature;
-    float potential;
-    int is_target;
     float information_density;
-    int material_id;
-    
+    uint8_t material_id;
+    uint8_t is_target;
+    uint16_t cooled_epoch : 9;      // Epocha, do ktorej je teplota ochladená
+    uint16_t temperature_level : 7; // Počiatočná úroveň teploty
+} __attribute__((aligned(16))) Cell;
+
+_Static_assert(sizeof(Cell) == 16, "Cell musí mať 16 B");
+_Static_assert(COOLING_EPOCHS < 512, "cooled_epoch má 9 bitov");
+_Static_assert(INITIAL_TEMPERATURE_LEVELS <= 128, "temperature_level má 7 bitov");
+
+typedef struct {
+    float q_values[4];          // Pamäť Q, mení sa iba atomicky
+    Cell hot;
+} __attribute__((aligned(32))) FusedCell;
+
+_Static_assert(sizeof(FusedCell) == 32, "FusedCell musí mať 32 B");
+
+typedef struct {
+    float potential;
     float effective_mass;
     float mobility;
-} Node;
+} Node;                         // Studené fyzikálne polia bunky
 
 typedef struct {
-    float q_values[4];
     int32_t last_visit;         // PRIDANÉ: int32_t
     float cumulative_reward;
     int32_t successful_exits;   // PRIDANÉ: int32_t
     int32_t evaluations;        // PRIDANÉ: int32_t
-    pthread_mutex_t mutex;
-} MemoryNode;
+} MemoryNode;                   // 16 B, polia sa menia iba atomicky
 
 typedef struct {
     int32_t steps;              // PRIDANÉ: int32_t
@@ -139,22 +198,118 @@ typedef struct {
     
 } SystemMetrics;
 
-/* ==================== GLOBÁLNE PREMENNÉ ==================== */
+/* Váhy lineárnej Q (--linear), opis v sekcii LINEÁRNA APROXIMÁCIA Q */
+#define LINEAR_FEATURES 32          // 19 príznakov, zvyšok nuly (násobok šírky)
+
+typedef struct {
+    float weights[4][LINEAR_FEATURES] __attribute__((aligned(64)));
+} LinearQ;
 
-int32_t dimension;              // ZMENENÉ: int32_t
-Node **world;
-MemoryNode **memory;
-Navigator agent;
-SystemMetrics metrics;
+/* ==================== GLOBÁLNE PREMENNÉ ==================== */
 
-int32_t target_x, target_y;     // ZMENENÉ: int32_t
-int32_t start_x, start_y;       // ZMENENÉ: int32_t
+/* Stav jedného behu. Program má jeden, knižnica jeden na simuláciu a
+ * replikáty jeden na vlákno; kód k nemu pristupuje cez sim, ktorý každé
+ * vlákno nastaví na stav svojho behu. */
+struct SimulationState {
+    int32_t dimension;              // ZMENENÉ: int32_t
+    int32_t tiles_per_side;         // Dlaždice TILE_SIDE×TILE_SIDE na stranu sveta
+    Cell *cells;                    // Horúce polia, dlaždica po dlaždici, krok 1 << cell_shift
+    int cell_shift;                 // log2 veľkosti záznamu: 5 (FusedCell), 4 pri --linear
+    FusedCell *q_table;             // Záznamy tabuľkového režimu, NULL pri --linear
+    Node *world;                    // Studené polia sveta (index cell_index)
+    MemoryNode *memory;             // Štatistika pamäte (index cell_index)
+    Navigator agent;
+    SystemMetrics metrics;
+    
+    int32_t target_x, target_y;     // ZMENENÉ: int32_t
+    int32_t start_x, start_y;       // ZMENENÉ: int32_t
+    
+    uint64_t world_seed;            // --seed: svet aj explorácia agenta
+    int32_t world_init_threads;     // --threads: 0 = všetky jadrá
+    double home_time;               // Nástenný čas behu do dosiahnutia cieľov [s]
+    double bar_time;
+    int quiet;                      // --quiet: bez baneru, priebehu a správy, jeden riadok metrík
+    Arena world_arena;              // Bunky, svet a pamäť (ďalší beh ju použije znova)
+    WorldImage world_image;         // Namapovaný súbor --world-dir počas inicializácie
+    struct random_data explore_rng; // Generátor explorácie (postupnosť ako srand/rand)
+    int32_t explore_rng_state[32];  // Jeho stav, 128 B ako pri srand
+    
+    // Lenivé chladenie a prírastkové metriky (opis pri ich sekciách)
+    int32_t cooling_epoch;
+    int64_t level_cells[INITIAL_TEMPERATURE_LEVELS];   // Nenavštívené bunky na úroveň
+    double visited_heat;            // Súčet teplôt navštívených buniek [K]
+    double quantum_coherence;       // Súčet koherencie buniek s pamäťou
+    int64_t quantum_cells;          // Bunky s aspoň jednou nenulovou Q-hodnotou
+    int quantum_incremental;        // 0: koherencia sa počíta skenom
+    
+    LinearQ linear_q;
+    int linear_enabled;             // --linear
+};
 
 pthread_mutex_t print_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t global_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+int init_only = 0;              // --init-only: iba meranie štartu
+int bench_entropy = 0;          // --bench-entropy: iba meranie jadra entropie
+
 /* ==================== POMOCNÉ FUNKCIE ==================== */
 
+/* Náhodné bity bunky [x][y] podľa riadkového indexu y·dimension + x, nie
+ * podľa dlaždíc: pri rovnakom seede má svet rovnaké materiály ako svet
+ * Kybernaut-Light. */
+static inline uint64_t cell_hash(int32_t x, int32_t y) {
+    return world_cell_hash(sim->world_seed, (uint64_t)y * sim->dimension + x);
+}
+
+/* Generátor explorácie patrí behu: rovnaká postupnosť ako srand(seed) a
+ * rand(), behy v rôznych vláknach sa však neovplyvnia */
+void explore_seed(uint64_t seed) {
+    memset(&sim->explore_rng, 0, sizeof(sim->explore_rng));
+    initstate_r((unsigned)seed, (char*)sim->explore_rng_state, sizeof(sim->explore_rng_state),
+                &sim->explore_rng);
+}
+
+static inline int32_t explore_rand() {
+    int32_t value;
+    random_r(&sim->explore_rng, &value);
+    return value;
+}
+
+/* Bity súradnice v dlaždici roztiahnuté na párne pozície Mortonovho kódu */
+static const uint8_t morton_spread[TILE_SIDE] = {0, 1, 4, 5, 16, 17, 20, 21};
+
+/* Dlaždice idú po riadkoch, bunky v dlaždici v Z-poradí: susedia v oboch
+ * smeroch ležia väčšinou v tých istých 1 KB */
+static inline size_t cell_index(int32_t x, int32_t y) {
+    size_t tile = (size_t)(x >> TILE_BITS) * sim->tiles_per_side + (y >> TILE_BITS);
+    return (tile << (2 * TILE_BITS)) |
+           ((size_t)morton_spread[x & (TILE_SIDE - 1)] << 1) | morton_spread[y & (TILE_SIDE - 1)];
+}
+
+static inline Cell *cell_at_index(size_t index) {
+    return (Cell*)((char*)sim->cells + (index << sim->cell_shift));
+}
+
+static inline Cell *cell_at(int32_t x, int32_t y) {
+    return cell_at_index(cell_index(x, y));
+}
+
+static inline float *cell_q(int32_t x, int32_t y) {
+    return sim->q_table[cell_index(x, y)].q_values;
+}
+
+/* Počet buniek vrátane okraja poslednej dlaždice */
+static inline size_t padded_cells() {
+    return (size_t)sim->tiles_per_side * sim->tiles_per_side << (2 * TILE_BITS);
+}
+
+/* Prechod všetkými bunkami sveta v poradí uloženia (dlaždica po dlaždici) */
+#define FOR_EACH_CELL(x, y) \
+    for (int32_t tile_x_ = 0; tile_x_ < sim->dimension; tile_x_ += TILE_SIDE) \
+    for (int32_t tile_y_ = 0; tile_y_ < sim->dimension; tile_y_ += TILE_SIDE) \
+    for (int32_t x = tile_x_; x < tile_x_ + TILE_SIDE && x < sim->dimension; x++) \
+    for (int32_t y = tile_y_; y < tile_y_ + TILE_SIDE && y < sim->dimension; y++)
+
 float physical_distance(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
     float dx = (x2 - x1) * CELL_SIZE;
     float dy = (y2 - y1) * CELL_SIZE;
@@ -163,25 +318,406 @@ float physical_distance(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
 
 float movement_cost(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y) {
     float distance = physical_distance(old_x, old_y, new_x, new_y);
-    Material mat_new = materials[world[new_x][new_y].material_id];
+    const Cell *cell = cell_at(new_x, new_y);
+    Material mat_new = materials[cell->material_id];
     
     float resistance_energy = mat_new.density * distance * 9.81 * CELL_SIZE;
-    float information_gain = 1.0 / (world[new_x][new_y].visits + 1.0);
+    float information_gain = 1.0 / (cell->visits + 1.0);
     
     float cost = resistance_energy * (1.0 / ENERGY_UNIT) - information_gain * 10.0;
     
     return fmax(cost, 0.1);
 }
 
+/* Posun smeru 0-3 (hore, dole, vpravo, vľavo v poradí rozhodovania agenta) */
+static const int32_t move_dx[4] = {0, 0, 1, -1};
+static const int32_t move_dy[4] = {1, -1, 0, 0};
+
+static inline int move_valid(int32_t x, int32_t y, int d) {
+    int32_t nx = x + move_dx[d];
+    int32_t ny = y + move_dy[d];
+    return nx >= 0 && nx < sim->dimension && ny >= 0 && ny < sim->dimension;
+}
+
+/* ==================== LENIVÉ CHLADENIE ==================== */
+
+/* Každých COOLING_INTERVAL krokov sa celý svet ochladí o 1 % rozdielu
+ * k 293.15 K. Namiesto prechodu cez dimension² buniek sa iba zvýši
+ * cooling_epoch a bunka sa dochladí až pri čítaní či zápise. Dochladenie
+ * opakuje presne tú istú float aritmetiku ako pôvodný prechod (uzavretý
+ * tvar 0.99^k by sa líšil v posledných bitoch). Nenavštívená bunka má
+ * stále počiatočnú teplotu jednej zo 100 úrovní, jej teplotu po k epochách
+ * preto dáva tabuľka; epochy sa opakujú iba na navštívených bunkách. */
+float cooled_temperature[INITIAL_TEMPERATURE_LEVELS][COOLING_EPOCHS + 1];
+
+static inline float initial_temperature(int level) {
+    return 293.15 + level / 100.0 * 10.0;
+}
+
+static inline float cool_once(float temperature) {
+    float cooling = (293.15 - temperature) * 0.01;
+    return temperature + cooling;
+}
+
+/* Tabuľka nezávisí od sveta, program aj knižnica ju počítajú raz */
+void init_cooling_table() {
+    for (int level = 0; level < INITIAL_TEMPERATURE_LEVELS; level++) {
+        cooled_temperature[level][0] = initial_temperature(level);
+        for (int32_t k = 1; k <= COOLING_EPOCHS; k++) {
+            cooled_temperature[level][k] = cool_once(cooled_temperature[level][k - 1]);
+        }
+    }
+}
+
+/* Dochladí bunku na aktuálnu epochu a vráti jej teplotu */
+static inline float cell_temperature(Cell *node) {
+    if (node->cooled_epoch != sim->cooling_epoch) {
+        if (node->visits == 0) {
+            node->temperature = cooled_temperature[node->temperature_level][sim->cooling_epoch];
+        } else {
+            for (int32_t k = node->cooled_epoch; k < sim->cooling_epoch; k++) {
+                node->temperature = cool_once(node->temperature);
+            }
+        }
+        node->cooled_epoch = sim->cooling_epoch;
+    }
+    return node->temperature;
+}
+
+static inline float node_temperature(int32_t x, int32_t y) {
+    return cell_temperature(cell_at(x, y));
+}
+
+/* ==================== PRÍRASTKOVÉ METRIKY ==================== */
+
+/* Pokrytie, kvantová koherencia a súčet teploty sa menia s udalosťami
+ * namiesto prechodu cez dimension² buniek. Pokrytie rastie pri prvej
+ * návšteve bunky. Pri zápise Q-hodnoty sa odčíta starý príspevok bunky ku
+ * koherencii a pripočíta nový. Nenavštívená bunka má teplotu z tabuľky
+ * chladenia, stačí teda počet takých buniek na úroveň; súčet navštívených
+ * sa raz za epochu ochladí tou istou lineárnou rovnicou ako každá bunka.
+ * Súčty sú v double, odčítanie a pripočítanie preto nehromadí chybu.
+ * Pamäť Q, do ktorej píše viac vlákien (zametanie, Hogwild) alebo ktorú
+ * nahrádza --linear, sa naďalej skenuje. */
+/* Koherencia Q-hodnôt bunky; vráti 0, ak bunka nemá pamäť */
+static inline int cell_coherence(const float *q, float *coherence) {
+    float max_q = -INFINITY;
+    float min_q = INFINITY;
+    int has_memory = 0;
+    
+    for (int d = 0; d < 4; d++) {
+        if (fabs(q[d]) > 1e-6) {
+            has_memory = 1;
+            if (q[d] > max_q) max_q = q[d];
+            if (q[d] < min_q) min_q = q[d];
+        }
+    }
+    if (!has_memory) return 0;
+    
+    if (fabs(max_q) > 1e-6) {
+        float spread = (max_q - min_q) / fabs(max_q);
+        *coherence = 1.0 - fmin(spread, 1.0);
+    } else {
+        *coherence = 1.0;
+    }
+    return 1;
+}
+
+/* Zápis Q-hodnôt bunky z old_q na new_q */
+static inline void quantum_track(const float *old_q, const float *new_q) {
+    float coherence;
+    if (cell_coherence(old_q, &coherence)) {
+        sim->quantum_coherence -= coherence;
+        sim->quantum_cells--;
+    }
+    if (cell_coherence(new_q, &coherence)) {
+        sim->quantum_coherence += coherence;
+        sim->quantum_cells++;
+    }
+}
+
+/* Prvá návšteva bunky; temperature je jej dochladená teplota */
+static inline void metrics_first_visit(const Cell *cell, float temperature) {
+    sim->level_cells[cell->temperature_level]--;
+    sim->visited_heat += temperature;
+    sim->metrics.visited_cells++;
+}
+
+/* Nová epocha chladenia: bunky sa dochladia lenivo, súčet tepla hneď */
+void cool_world() {
+    sim->cooling_epoch++;
+    sim->visited_heat += (293.15 * sim->metrics.visited_cells - sim->visited_heat) * 0.01;
+}
+
+/* Súčet teplôt všetkých buniek sveta [K] */
+double world_heat() {
+    double heat = sim->visited_heat;
+    for (int level = 0; level < INITIAL_TEMPERATURE_LEVELS; level++) {
+        heat += sim->level_cells[level] * (double)cooled_temperature[level][sim->cooling_epoch];
+    }
+    return heat;
+}
+
+/* ==================== ATOMICKÁ PAMÄŤ Q ==================== */
+
+/* Bunka pamäte nemá vlastný zámok (pthread_mutex_t mal 40 B, viac než
+ * samotné Q-hodnoty). Čítania sú atomické, Q-update a súčet odmien idú
+ * cez compare-and-swap: súbežný učiaci sa nikdy neprečíta roztrhnutú
+ * hodnotu a update z inej nite sa nestratí, iba sa prepočíta. Štatistiky
+ * nie sú synchronizačný bod, preto stačí uvoľnené poradie. */
+static inline float q_load(float *q) {
+    float value;
+    __atomic_load(q, &value, __ATOMIC_RELAXED);
+    return value;
+}
+
+/* Q ← Q + α·(r + γ·max_future_q - Q); vráti novú hodnotu */
+static inline float q_td_update(float *q, float reward, float max_future_q) {
+    float old_q = q_load(q);
+    float new_q;
+    do {
+        new_q = old_q + sim->agent.learning_rate * 
+               (reward + sim->agent.discount_factor * max_future_q - old_q);
+    } while (!__atomic_compare_exchange(q, &old_q, &new_q, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return new_q;
+}
+
+static inline void atomic_add_float(float *target, float value) {
+    float old_value = q_load(target);
+    float new_value;
+    do {
+        new_value = old_value + value;
+    } while (!__atomic_compare_exchange(target, &old_value, &new_value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* Najväčšia Q-hodnota bunky (aspoň 0 ako pri nepreskúmanej bunke) */
+static inline float q_max_future(float *cell_q_values) {
+    float max_future_q = 0.0;
+    for (int d = 0; d < 4; d++) {
+        float q = q_load(&cell_q_values[d]);
+        if (q > max_future_q) {
+            max_future_q = q;
+        }
+    }
+    return max_future_q;
+}
+
+/* Smer s najväčšou Q-hodnotou z povolených smerov bunky [x,y] (pri zhode
+ * prvý), -1 ak taký nie je. Štyri Q-hodnoty sú jeden vektor: nepovolené
+ * smery sa maskujú na -∞ a maximum sa nájde bez vetvení, ktoré pri
+ * podobných Q-hodnotách predikcia často netrafí. */
+typedef float qfloat __attribute__((vector_size(4 * sizeof(float))));
+typedef int32_t qint __attribute__((vector_size(4 * sizeof(int32_t))));
+
+static inline int q_argmax(float *q, int32_t x, int32_t y) {
+    qfloat value = {q_load(&q[0]), q_load(&q[1]), q_load(&q[2]), q_load(&q[3])};
+    qint nx = x + (qint){0, 0, 1, -1};
+    qint ny = y + (qint){1, -1, 0, 0};
+    qint valid = (nx >= 0) & (nx < sim->dimension) & (ny >= 0) & (ny < sim->dimension);
+    value = (qfloat)((valid & (qint)value) | (~valid & (qint)((qfloat){} - INFINITY)));
+    
+    qfloat best = value;
+    qfloat swapped = __builtin_shuffle(best, (qint){2, 3, 0, 1});
+    best = (qfloat)(((best > swapped) & (qint)best) | (~(best > swapped) & (qint)swapped));
+    swapped = __builtin_shuffle(best, (qint){1, 0, 3, 2});
+    best = (qfloat)(((best > swapped) & (qint)best) | (~(best > swapped) & (qint)swapped));
+    
+    if (!(best[0] > -INFINITY)) return -1;
+    qint winner = value == best;
+    for (int d = 0; d < 4; d++) {
+        if (winner[d]) return d;
+    }
+    return -1;
+}
+
+/* Zápis výsledku prechodu z bunky [x,y] smerom direction */
+void memory_record_transition(int32_t x, int32_t y, int direction, float reward,
+                              float max_future_q, int32_t step) {
+    size_t index = cell_index(x, y);
+    MemoryNode *stats = &sim->memory[index];
+    float *q = sim->q_table[index].q_values;
+    if (sim->quantum_incremental) {
+        float old_q[4] = {q[0], q[1], q[2], q[3]};
+        q_td_update(&q[direction], reward, max_future_q);
+        quantum_track(old_q, q);
+    } else {
+        q_td_update(&q[direction], reward, max_future_q);
+    }
+    atomic_add_float(&stats->cumulative_reward, reward);
+    __atomic_store_n(&stats->last_visit, step, __ATOMIC_RELAXED);
+    if (reward > 0) __atomic_fetch_add(&stats->successful_exits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->evaluations, 1, __ATOMIC_RELAXED);
+}
+
+/* ==================== LINEÁRNA APROXIMÁCIA Q ==================== */
+
+/* S --linear sa pamäť Q nealokuje (32 B na bunku). Q(s,a) je skalárny
+ * súčin váh smeru a s príznakmi cieľovej bunky v = s + a: materiál,
+ * priblíženie k cieľu a vzdialenosť od neho, novosť bunky, hustota
+ * návštev v okolí 3×3, príznak cieľa a sektor smeru k cieľu zo s. Váhy
+ * zaberajú 4·LINEAR_FEATURES floatov bez ohľadu na rozmer sveta. Učenie je
+ * normalizovaný TD krok (α/|φ|²) na preškálovanej odmene linear_reward.
+ * Súčiny idú po vektoroch pevnej šírky LINEAR_WIDTH, aby poradie súčtov
+ * a tým aj váhy nezáviseli od CPU. */
+#define LINEAR_WIDTH 16
+
+typedef float lfloat __attribute__((vector_size(LINEAR_WIDTH * sizeof(float))));
+
+static inline float linear_dot(const float *a, const float *b) {
+    lfloat sum = {0};
+    for (int i = 0; i < LINEAR_FEATURES; i += LINEAR_WIDTH) {
+        lfloat va, vb;
+        memcpy(&va, a + i, sizeof(va));
+        memcpy(&vb, b + i, sizeof(vb));
+        sum += va * vb;
+    }
+    float total = 0.0;
+    for (int l = 0; l < LINEAR_WIDTH; l++) total += sum[l];
+    return total;
+}
+
+/* Príznaky prechodu z [x,y] smerom d (smer musí byť povolený) */
+void linear_features(int32_t x, int32_t y, int d, float *phi) {
+    int32_t nx = x + move_dx[d];
+    int32_t ny = y + move_dy[d];
+    const Cell *v = cell_at(nx, ny);
+    memset(phi, 0, LINEAR_FEATURES * sizeof(float));
+    
+    phi[0] = 1.0;
+    phi[1 + v->material_id] = 1.0;
+    
+    float old_dist = physical_distance(x, y, sim->target_x, sim->target_y);
+    float new_dist = physical_distance(nx, ny, sim->target_x, sim->target_y);
+    phi[6] = (old_dist - new_dist) / CELL_SIZE;
+    phi[7] = new_dist / (sim->dimension * CELL_SIZE);
+    phi[8] = 1.0 / (v->visits + 1.0);
+    
+    int visited = 0, neighbours = 0;
+    for (int32_t i = nx - 1; i <= nx + 1; i++) {
+        for (int32_t j = ny - 1; j <= ny + 1; j++) {
+            if (i < 0 || i >= sim->dimension || j < 0 || j >= sim->dimension) continue;
+            neighbours++;
+            visited += cell_at(i, j)->visits > 0;
+        }
+    }
+    phi[9] = (float)visited / neighbours;
+    phi[10] = (nx == sim->target_x && ny == sim->target_y) ? 1.0 : 0.0;
+    
+    // Sektor 0-7 uhla od [x,y] k cieľu (v cieli sektor 0)
+    float angle = atan2f((float)(sim->target_y - y), (float)(sim->target_x - x));
+    int sector = (int)floorf((angle + (float)M_PI) / (float)(M_PI / 4.0) + 0.5f) & 7;
+    phi[11 + sector] = 1.0;
+}
+
+float linear_q_value(int32_t x, int32_t y, int d) {
+    float phi[LINEAR_FEATURES] __attribute__((aligned(64)));
+    linear_features(x, y, d, phi);
+    return linear_dot(sim->linear_q.weights[d], phi);
+}
+
+/* Q-hodnoty bunky; nepovolené smery majú 0 ako v tabuľke */
+void linear_q_values(int32_t x, int32_t y, float *q) {
+    for (int d = 0; d < 4; d++) {
+        q[d] = move_valid(x, y, d) ? linear_q_value(x, y, d) : 0.0f;
+    }
+}
+
+/* Obdoba q_max_future: najväčšia Q-hodnota bunky, aspoň 0 */
+float linear_q_max(int32_t x, int32_t y) {
+    float q[4];
+    linear_q_values(x, y, q);
+    float max_future_q = 0.0;
+    for (int d = 0; d < 4; d++) {
+        if (q[d] > max_future_q) max_future_q = q[d];
+    }
+    return max_future_q;
+}
+
+/* Odmena pre lineárne učenie: členy transition_reward v jednotkách
+ * ENERGY_UNIT, cena pohybu však delená cenou kroku vodou. V transition_reward
+ * má cena rád 1e11 jednotiek a cieľ (100), novosť (10) ani priblíženie
+ * (1 na bunku) sa pri nej vo floate vôbec neprejavia. Tabuľku k cieľu
+ * dovedie optimizmus nulových Q-hodnôt nenavštívených buniek, lineárny
+ * aproximátor ho nemá a bez preškálovania sa učí iba vyhýbať materiálom. */
+float linear_reward(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y) {
+    const Cell *cell = cell_at(new_x, new_y);
+    float reward = 0.0;
+    
+    if ((cell->is_target == 1 && !sim->agent.home_reached) ||
+        (cell->is_target == 2 && !sim->agent.bar_reached)) {
+        reward += 100.0;
+    }
+    if (cell->visits == 1) reward += 10.0;      // Návšteva je už započítaná
+    
+    float water_cost = materials[1].density * CELL_SIZE * 9.81 * CELL_SIZE * (1.0 / ENERGY_UNIT);
+    reward -= 0.1 * movement_cost(old_x, old_y, new_x, new_y) / water_cost;
+    
+    float old_dist = physical_distance(old_x, old_y, sim->target_x, sim->target_y);
+    float new_dist = physical_distance(new_x, new_y, sim->target_x, sim->target_y);
+    reward += (old_dist - new_dist) / CELL_SIZE;
+    
+    return reward;
+}
+
+void linear_update(int32_t x, int32_t y, int d, float reward, float max_future_q) {
+    float phi[LINEAR_FEATURES] __attribute__((aligned(64)));
+    linear_features(x, y, d, phi);
+    
+    float *w = sim->linear_q.weights[d];
+    float td_error = reward + sim->agent.discount_factor * max_future_q - linear_dot(w, phi);
+    float step = sim->agent.learning_rate * td_error / linear_dot(phi, phi);
+    for (int i = 0; i < LINEAR_FEATURES; i++) {
+        w[i] += step * phi[i];
+    }
+}
+
+/* ==================== REDUKCIA TEPELNÉHO POĽA (SIMD) ==================== */
+
+/* Chladenie mení teplotu každej bunky, tepelnú entropiu preto nejde
+ * udržiavať priebežne. Jadro (SIMD súčty z kybernaut_common.h) prejde
+ * bunky dlaždicu po dlaždici, blok redukcie je riadok dlaždíc a súčty idú
+ * po dlaždiciach. Nenavštívená bunka má teplotu z tabuľky chladenia podľa
+ * svojej úrovne a jadro ju iba číta, navštívené sa dochladia ako pri
+ * každom prístupe. */
+KERNEL_INLINE void* thermal_worker_body(int width, void *arg) {
+    ThermalWorker *w = (ThermalWorker*)arg;
+    const float *level_temperature = &cooled_temperature[0][sim->cooling_epoch];
+    float tile[TILE_SIDE * TILE_SIDE] __attribute__((aligned(64)));
+    
+    for (int64_t row = w->first; row < sim->tiles_per_side; row += w->stride) {
+        int32_t tile_x = (int32_t)row * TILE_SIDE;
+        for (int32_t tile_y = 0; tile_y < sim->dimension; tile_y += TILE_SIDE) {
+            int count = 0;
+            for (int32_t x = tile_x; x < tile_x + TILE_SIDE && x < sim->dimension; x++) {
+                for (int32_t y = tile_y; y < tile_y + TILE_SIDE && y < sim->dimension; y++) {
+                    Cell *node = cell_at(x, y);
+                    tile[count++] = node->visits == 0
+                        ? level_temperature[node->temperature_level * (COOLING_EPOCHS + 1)]
+                        : cell_temperature(node);
+                }
+            }
+            thermal_block_sums(width, tile, count, &w->sum, &w->xlogx_sum);
+        }
+    }
+    
+    return NULL;
+}
+
+KERNEL_WIDTH_VARIANTS(void*, thermal_worker, (void *arg), (arg))
+
+/* Tepelná entropia celého sveta vo world_init_threads vláknach */
+float thermal_entropy_kernel() {
+    int32_t threads = sim->world_init_threads < sim->tiles_per_side ? sim->world_init_threads : sim->tiles_per_side;
+    return thermal_entropy_reduce(thermal_worker, threads, (double)sim->dimension * sim->dimension);
+}
+
 /* ==================== OPRAVENÝ VÝPOČET ENTROPIÍ ==================== */
 
 float calculate_information_entropy() {
     int64_t total_visits = 0;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            total_visits += world[x][y].visits;
-        }
+    FOR_EACH_CELL(x, y) {
+        total_visits += cell_at(x, y)->visits;
     }
     
     if (total_visits == 0) return 0.0;
@@ -189,16 +725,14 @@ float calculate_information_entropy() {
     float entropy = 0.0;
     float log2 = log(2.0);
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            float p = (float)world[x][y].visits / total_visits;
-            if (p > 0.0) {
-                entropy -= p * (log(p) / log2);
-            }
+    FOR_EACH_CELL(x, y) {
+        float p = (float)cell_at(x, y)->visits / total_visits;
+        if (p > 0.0) {
+            entropy -= p * (log(p) / log2);
         }
     }
     
-    float max_entropy = log(dimension * dimension) / log2;
+    float max_entropy = log(sim->dimension * sim->dimension) / log2;
     if (max_entropy > 0.0) {
         entropy /= max_entropy;
     }
@@ -206,30 +740,27 @@ float calculate_information_entropy() {
     if (entropy < 0.0) entropy = 0.0;
     if (entropy > 1.0) entropy = 1.0;
     
-    metrics.information_entropy = entropy;
+    sim->metrics.information_entropy = entropy;
     return entropy;
 }
 
-float calculate_thermal_entropy() {
+/* Pôvodný dvojprechod s dochladením buniek - referencia pre --bench-entropy */
+float calculate_thermal_entropy_scalar() {
     float total_heat = 0.0;
-    int64_t cells = dimension * dimension;
+    int64_t cells = sim->dimension * sim->dimension;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            total_heat += world[x][y].temperature;
-        }
+    FOR_EACH_CELL(x, y) {
+        total_heat += node_temperature(x, y);
     }
     
     if (total_heat <= 0.0) return 0.0;
     
     float entropy = 0.0;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            float p = world[x][y].temperature / total_heat;
-            if (p > 0.0) {
-                entropy -= p * log(p);
-            }
+    FOR_EACH_CELL(x, y) {
+        float p = cell_at(x, y)->temperature / total_heat;  // Dochladené vyššie
+        if (p > 0.0) {
+            entropy -= p * log(p);
         }
     }
     
@@ -241,132 +772,228 @@ float calculate_thermal_entropy() {
     if (entropy < 0.0) entropy = 0.0;
     if (entropy > 1.0) entropy = 1.0;
     
-    metrics.thermal_entropy = entropy;
     return entropy;
 }
 
-float calculate_quantum_entropy() {
-    float total_coherence = 0.0;
-    int32_t cells_with_memory = 0;
-    
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            float max_q = -INFINITY;
-            float min_q = INFINITY;
-            int has_memory = 0;
-            
-            pthread_mutex_lock(&memory[x][y].mutex);
-            for (int d = 0; d < 4; d++) {
-                if (fabs(memory[x][y].q_values[d]) > 1e-6) {
-                    has_memory = 1;
-                    if (memory[x][y].q_values[d] > max_q) max_q = memory[x][y].q_values[d];
-                    if (memory[x][y].q_values[d] < min_q) min_q = memory[x][y].q_values[d];
-                }
-            }
-            pthread_mutex_unlock(&memory[x][y].mutex);
-            
-            if (has_memory) {
-                cells_with_memory++;
-                
-                if (fabs(max_q) > 1e-6) {
-                    float spread = (max_q - min_q) / fabs(max_q);
-                    float coherence = 1.0 - fmin(spread, 1.0);
-                    total_coherence += coherence;
-                } else {
-                    total_coherence += 1.0;
-                }
-            }
+float calculate_thermal_entropy() {
+    sim->metrics.thermal_entropy = thermal_entropy_kernel();
+    return sim->metrics.thermal_entropy;
+}
+
+/* Koherencia celej pamäte skenom (po hromadnom zápise Q alebo bez sledovania) */
+void quantum_rebuild() {
+    sim->quantum_coherence = 0.0;
+    sim->quantum_cells = 0;
+    
+    FOR_EACH_CELL(x, y) {
+        // Lineárna Q nemá pamäť buniek - počíta sa z navštívených
+        float cell_q[4];
+        if (sim->linear_enabled) {
+            if (cell_at(x, y)->visits == 0) continue;
+            linear_q_values(x, y, cell_q);
+        } else {
+            for (int d = 0; d < 4; d++) cell_q[d] = q_load(&sim->q_table[cell_index(x, y)].q_values[d]);
+        }
+        
+        float coherence;
+        if (cell_coherence(cell_q, &coherence)) {
+            sim->quantum_coherence += coherence;
+            sim->quantum_cells++;
+        }
+    }
+}
+
+/* Pokrytie a teplo skenom - po behu agentov, ktorí ich priebežne nepočítajú */
+void metrics_rebuild() {
+    memset(sim->level_cells, 0, sizeof(sim->level_cells));
+    sim->metrics.visited_cells = 0;
+    sim->visited_heat = 0.0;
+    
+    FOR_EACH_CELL(x, y) {
+        Cell *cell = cell_at(x, y);
+        float temperature = cell_temperature(cell);
+        if (cell->visits > 0) {
+            sim->metrics.visited_cells++;
+            sim->visited_heat += temperature;
+        } else {
+            sim->level_cells[cell->temperature_level]++;
         }
     }
+}
+
+float calculate_quantum_entropy() {
+    if (!sim->quantum_incremental) {
+        quantum_rebuild();
+    }
     
-    float avg_coherence = (cells_with_memory > 0) ? total_coherence / cells_with_memory : 1.0;
+    float avg_coherence = (sim->quantum_cells > 0) ? sim->quantum_coherence / sim->quantum_cells : 1.0;
     float quantum_entropy = 1.0 - avg_coherence;
     
     if (quantum_entropy < 0.0) quantum_entropy = 0.0;
     if (quantum_entropy > 1.0) quantum_entropy = 1.0;
     
-    metrics.quantum_entropy = quantum_entropy;
+    sim->metrics.quantum_entropy = quantum_entropy;
     return quantum_entropy;
 }
 
 /* ==================== FYZIKÁLNA PROJEKCIA 3D→2D ==================== */
 
-void init_world_physical(int32_t dim) {
-    dimension = dim;
+/* Vlákno inicializácie: bloky stĺpcov first_block + k·block_stride */
+typedef struct {
+    pthread_t thread;
+    int32_t first_block, block_stride;
+} WorldInitWorker;
+
+void* world_init_worker(void *arg) {
+    WorldInitWorker *w = (WorldInitWorker*)arg;
+    int64_t levels[INITIAL_TEMPERATURE_LEVELS] = {0};
+    
+    for (int32_t b = w->first_block; b * INIT_BLOCK_COLUMNS < sim->dimension; b += w->block_stride) {
+        int32_t x_end = (b + 1) * INIT_BLOCK_COLUMNS;
+        if (x_end > sim->dimension) x_end = sim->dimension;
+        
+        for (int32_t x = b * INIT_BLOCK_COLUMNS; x < x_end; x++) {
+            for (int32_t y = 0; y < sim->dimension; y++) {
+                int material, level;
+                if (sim->world_image.material) {
+                    size_t row = (size_t)y * sim->dimension + x;
+                    material = sim->world_image.material[row];
+                    level = sim->world_image.level[row];
+                } else {
+                    uint64_t hash = cell_hash(x, y);
+                    material = cell_initial_material(hash);
+                    level = cell_initial_temperature_level(hash);
+                }
+                size_t index = cell_index(x, y);
+                Cell *node = cell_at_index(index);
+                Node *cold = &sim->world[index];
+                
+                node->visits = 0;
+                node->temperature = initial_temperature(level);
+                node->temperature_level = level;
+                levels[level]++;
+                node->cooled_epoch = 0;
+                node->material_id = material;
+                
+                Material mat = materials[node->material_id];
+                
+                cold->potential = mat.density * 9.81 * CELL_SIZE;
+                cold->effective_mass = mat.density * CELL_SIZE * CELL_SIZE;
+                cold->mobility = 1.0 / (mat.young_modulus * TIME_STEP);
+                
+                node->is_target = 0;
+                node->information_density = 0.0;
+            }
+        }
+    }
     
-    world = (Node**)malloc(dimension * sizeof(Node*));
-    if (!world) {
-        printf("Chyba: Nedostatok pamäte pre %"PRId32" riadkov\n", dimension);
+    for (int level = 0; level < INITIAL_TEMPERATURE_LEVELS; level++) {
+        __atomic_fetch_add(&sim->level_cells[level], levels[level], __ATOMIC_RELAXED);
+    }
+    
+    return NULL;
+}
+
+/* Spustí worker nad blokmi stĺpcov vo world_init_threads vláknach */
+void run_column_workers(void* (*worker)(void*)) {
+    int32_t blocks = (sim->dimension + INIT_BLOCK_COLUMNS - 1) / INIT_BLOCK_COLUMNS;
+    int32_t threads = sim->world_init_threads < blocks ? sim->world_init_threads : blocks;
+    WorldInitWorker *workers = (WorldInitWorker*)calloc(threads, sizeof(WorldInitWorker));
+    if (!workers) {
+        printf("Chyba: Nedostatok pamäte pre inicializáciu sveta\n");
         exit(1);
     }
     
-    for (int32_t i = 0; i < dimension; i++) {
-        world[i] = (Node*)malloc(dimension * sizeof(Node));
-        if (!world[i]) {
-            printf("Chyba: Nedostatok pamäte pre %"PRId32" stĺpcov\n", dimension);
-            exit(1);
-        }
+    for (int32_t t = 0; t < threads; t++) {
+        workers[t].first_block = t;
+        workers[t].block_stride = threads;
+        simulation_thread_create(&workers[t].thread, worker, &workers[t]);
+    }
+    for (int32_t t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    free(workers);
+}
+
+/* Bajty poľa z count prvkov zaokrúhlené na riadok cache */
+static inline size_t arena_block_bytes(size_t count, size_t size) {
+    return (count * size + 63) & ~(size_t)63;
+}
+
+void init_world_physical(int32_t dim, const char *dir) {
+    sim->dimension = dim;
+    sim->tiles_per_side = (sim->dimension + TILE_SIDE - 1) / TILE_SIDE;
+    
+    // Aréna: bunky (FusedCell, pri --linear Cell), studené polia sveta
+    // a štatistika pamäte (okrem --linear); stránky pamäte vzniknú až
+    // v init_memory
+    size_t count = padded_cells();
+    size_t cells_bytes = arena_block_bytes(count, sim->linear_enabled ? sizeof(Cell) : sizeof(FusedCell));
+    size_t world_bytes = arena_block_bytes(count, sizeof(Node));
+    size_t memory_bytes = sim->linear_enabled ? 0 : arena_block_bytes(count, sizeof(MemoryNode));
+    char *base = (char*)arena_reserve(&sim->world_arena, cells_bytes + world_bytes + memory_bytes);
+    if (!base) {
+        printf("Chyba: Nedostatok pamäte pre svet %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
+        exit(1);
     }
     
-    printf("Inicializujem fyzikálny svet %"PRId32"x%"PRId32" (%"PRId64" buniek)...\n", 
-           dimension, dimension, (int64_t)dimension * dimension);
+    if (sim->linear_enabled) {
+        sim->q_table = NULL;
+        sim->cells = (Cell*)base;
+        sim->cell_shift = 4;
+    } else {
+        sim->q_table = (FusedCell*)base;
+        sim->cells = &sim->q_table->hot;
+        sim->cell_shift = 5;
+    }
+    sim->world = (Node*)(base + cells_bytes);
+    sim->memory = sim->linear_enabled ? NULL : (MemoryNode*)(base + cells_bytes + world_bytes);
     
-    for (int32_t y = 0; y < dimension; y++) {
-        for (int32_t x = 0; x < dimension; x++) {
-            world[x][y].x = x;
-            world[x][y].y = y;
-            world[x][y].visits = 0;
-            world[x][y].temperature = 293.15 + (rand() % 100) / 100.0 * 10.0;
-            
-            float r = (rand() % 1000) / 1000.0;
-            if (r < 0.40) {
-                world[x][y].material_id = 0;
-            } else if (r < 0.70) {
-                world[x][y].material_id = 1;
-            } else if (r < 0.90) {
-                world[x][y].material_id = 2;
-            } else if (r < 0.97) {
-                world[x][y].material_id = 3;
-            } else {
-                world[x][y].material_id = 4;
-            }
-            
-            Material mat = materials[world[x][y].material_id];
-            
-            world[x][y].potential = mat.density * 9.81 * CELL_SIZE;
-            world[x][y].effective_mass = mat.density * CELL_SIZE * CELL_SIZE;
-            world[x][y].mobility = 1.0 / (mat.young_modulus * TIME_STEP);
-            
-            world[x][y].is_target = 0;
-            world[x][y].information_density = 0.0;
+    if (!sim->quiet) {
+        printf("Inicializujem fyzikálny svet %"PRId32"x%"PRId32" (%"PRId64" buniek, %"PRId32" vlákien)...\n", 
+               sim->dimension, sim->dimension, (int64_t)sim->dimension * sim->dimension, sim->world_init_threads);
+    }
+    if (dir) {
+        world_image_open(&sim->world_image, dir, sim->dimension, sim->world_seed);
+        if (!sim->quiet) {
+            printf("  • Zdieľaný svet: %s (%s)\n", sim->world_image.path,
+                   sim->world_image.generated ? "vygenerovaný" : "namapovaný");
         }
     }
     
-    world[0][0].is_target = 1;
-    world[0][0].material_id = 2;
+    sim->cooling_epoch = 0;
+    memset(sim->level_cells, 0, sizeof(sim->level_cells));
+    run_column_workers(world_init_worker);
+    world_image_close(&sim->world_image);
+    
+    cell_at(0, 0)->is_target = 1;
+    cell_at(0, 0)->material_id = 2;
     
-    world[dimension-1][dimension-1].is_target = 2;
-    world[dimension-1][dimension-1].material_id = 1;
+    cell_at(sim->dimension-1, sim->dimension-1)->is_target = 2;
+    cell_at(sim->dimension-1, sim->dimension-1)->material_id = 1;
 }
 
-float physical_reward(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y) {
+/* Odmena prechodu pre agenta s cieľom [goal_x,goal_y] a stavom cieľov */
+float transition_reward(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y,
+                        int32_t goal_x, int32_t goal_y, int32_t home_reached, int32_t bar_reached) {
     float reward = 0.0;
+    const Cell *cell = cell_at(new_x, new_y);
     
-    if (world[new_x][new_y].is_target == 1 && !agent.home_reached) {
+    if (cell->is_target == 1 && !home_reached) {
         reward += 100.0 * ENERGY_UNIT;
-    } else if (world[new_x][new_y].is_target == 2 && !agent.bar_reached) {
+    } else if (cell->is_target == 2 && !bar_reached) {
         reward += 100.0 * ENERGY_UNIT;
     }
     
-    if (world[new_x][new_y].visits == 0) {
+    if (cell->visits == 0) {
         reward += 10.0 * ENERGY_UNIT;
     }
     
     float cost = movement_cost(old_x, old_y, new_x, new_y);
     reward -= cost * 0.1;
     
-    float old_dist = physical_distance(old_x, old_y, target_x, target_y);
-    float new_dist = physical_distance(new_x, new_y, target_x, target_y);
+    float old_dist = physical_distance(old_x, old_y, goal_x, goal_y);
+    float new_dist = physical_distance(new_x, new_y, goal_x, goal_y);
     
     if (new_dist < old_dist) {
         reward += (old_dist - new_dist) / CELL_SIZE * ENERGY_UNIT;
@@ -377,392 +1004,1983 @@ float physical_reward(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y
     return reward;
 }
 
+float physical_reward(int32_t old_x, int32_t old_y, int32_t new_x, int32_t new_y) {
+    return transition_reward(old_x, old_y, new_x, new_y, sim->target_x, sim->target_y,
+                             sim->agent.home_reached, sim->agent.bar_reached);
+}
+
 /* ==================== INICIALIZÁCIA ==================== */
 
-void init_memory() {
-    memory = (MemoryNode**)malloc(dimension * sizeof(MemoryNode*));
-    if (!memory) {
-        printf("Chyba: Nedostatok pamäte pre pamäť\n");
-        exit(1);
-    }
+/* Vlákno inicializácie pamäte: prvý dotyk rovnakých blokov stĺpcov ako svet */
+void* memory_init_worker(void *arg) {
+    WorldInitWorker *w = (WorldInitWorker*)arg;
     
-    for (int32_t i = 0; i < dimension; i++) {
-        memory[i] = (MemoryNode*)malloc(dimension * sizeof(MemoryNode));
-        if (!memory[i]) {
-            printf("Chyba: Nedostatok pamäte pre pamäťové bunky\n");
-            exit(1);
-        }
+    for (int32_t b = w->first_block; b * INIT_BLOCK_COLUMNS < sim->dimension; b += w->block_stride) {
+        int32_t i_end = (b + 1) * INIT_BLOCK_COLUMNS;
+        if (i_end > sim->dimension) i_end = sim->dimension;
         
-        for (int32_t j = 0; j < dimension; j++) {
-            for (int d = 0; d < 4; d++) {
-                memory[i][j].q_values[d] = 0.0;
+        for (int32_t i = b * INIT_BLOCK_COLUMNS; i < i_end; i++) {
+            for (int32_t j = 0; j < sim->dimension; j++) {
+                size_t index = cell_index(i, j);
+                for (int d = 0; d < 4; d++) {
+                    sim->q_table[index].q_values[d] = 0.0;
+                }
+                MemoryNode *stats = &sim->memory[index];
+                stats->last_visit = -1;
+                stats->cumulative_reward = 0.0;
+                stats->successful_exits = 0;
+                stats->evaluations = 0;
             }
-            memory[i][j].last_visit = -1;
-            memory[i][j].cumulative_reward = 0.0;
-            memory[i][j].successful_exits = 0;
-            memory[i][j].evaluations = 0;
-            pthread_mutex_init(&memory[i][j].mutex, NULL);
         }
     }
+    
+    return NULL;
+}
+
+/* Q-hodnoty vynulovala už inicializácia sveta (sú v bunke Cell) */
+void init_memory() {
+    run_column_workers(memory_init_worker);
 }
 
 void init_agent() {
-    agent.steps = 0;
-    agent.total_energy_cost = 0.0;
-    agent.total_information = 0.0;
-    agent.path_index = 0;
-    agent.home_reached = 0;
-    agent.bar_reached = 0;
-    
-    agent.learning_rate = 0.18;
-    agent.discount_factor = 0.92;
-    agent.exploration_rate = 0.35;
-    
-    agent.decisions_made = 0;
-    agent.parallel_evals = 0;
-    agent.stm_index = 0;
-    agent.efficiency_index = 0;
-    
-    agent.learning_entropy = 0.0;
-    agent.computational_cost = 1.0e-18;
-    
-    metrics.information_entropy = 0.0;
-    metrics.thermal_entropy = 0.0;
-    metrics.quantum_entropy = 0.0;
-    
-    metrics.total_energy_used = 0.0;
-    metrics.average_temperature = 293.15;
-    metrics.information_efficiency = 0.0;
-    
-    metrics.total_cells = (int64_t)dimension * dimension;
-    metrics.visited_cells = 0;
-    metrics.coverage = 0.0;
-    
-    metrics.learning_efficiency = 0.0;
-    metrics.decision_quality = 0.0;
+    sim->agent.steps = 0;
+    sim->agent.total_energy_cost = 0.0;
+    sim->agent.total_information = 0.0;
+    sim->agent.path_index = 0;
+    sim->agent.home_reached = 0;
+    sim->agent.bar_reached = 0;
+    
+    sim->agent.learning_rate = 0.18;
+    sim->agent.discount_factor = 0.92;
+    sim->agent.exploration_rate = 0.35;
+    
+    sim->agent.decisions_made = 0;
+    sim->agent.parallel_evals = 0;
+    sim->agent.stm_index = 0;
+    sim->agent.efficiency_index = 0;
+    
+    sim->agent.learning_entropy = 0.0;
+    sim->agent.computational_cost = 1.0e-18;
+    
+    sim->metrics.information_entropy = 0.0;
+    sim->metrics.thermal_entropy = 0.0;
+    sim->metrics.quantum_entropy = 0.0;
+    
+    sim->metrics.total_energy_used = 0.0;
+    sim->metrics.average_temperature = 293.15;
+    sim->metrics.information_efficiency = 0.0;
+    
+    sim->metrics.total_cells = (int64_t)sim->dimension * sim->dimension;
+    sim->metrics.visited_cells = 0;
+    sim->metrics.coverage = 0.0;
+    sim->visited_heat = 0.0;
+    sim->quantum_coherence = 0.0;
+    sim->quantum_cells = 0;
+    
+    sim->metrics.learning_efficiency = 0.0;
+    sim->metrics.decision_quality = 0.0;
 }
 
-/* ==================== HLAVNÁ SIMULÁCIA ==================== */
+/* ==================== CENA K CIEĽU ==================== */
 
-void run_simulation() {
-    int32_t pos_x = start_x;
-    int32_t pos_y = start_y;
-    
-    printf("\n[KYBERNAUT-HUMAN v3.1] Fyzikálne korektná simulácia\n");
-    printf("=====================================================\n");
-    printf("Projekcia 3D→2D:\n");
-    printf("  • Bunka: %.1e m\n", CELL_SIZE);
-    printf("  • Časový krok: %.1e s\n", TIME_STEP);
-    printf("  • Energetická jednotka: %.1e J\n", ENERGY_UNIT);
-    printf("  • Rozmer sveta: %"PRId32"x%"PRId32"\n", dimension, dimension);
-    printf("=====================================================\n");
-    
-    int32_t last_print = 0;
-    
-    while (agent.steps < MAX_STEPS) {
-        if (agent.steps % 100 == 0) {
-            for (int32_t x = 0; x < dimension; x++) {
-                for (int32_t y = 0; y < dimension; y++) {
-                    float cooling = (293.15 - world[x][y].temperature) * 0.01;
-                    world[x][y].temperature += cooling;
-                }
+/* S --cost-to-go sa pred simuláciou pre oba ciele vypočíta pole
+ * G(v) = cena vstupu do v + najlacnejšia cena cesty z v do cieľa, obe
+ * z movement_cost nenavštíveného sveta. Q(s,a) sa potom predvyplní na
+ * -0.1·G(sused v smere a) - rovnaká váha, akou cena vstupuje do odmeny -
+ * takže hltavá voľba hneď sleduje najlacnejšiu cestu.
+ *
+ * Cena vstupu závisí iba od materiálu cieľovej bunky (vzdialenosť je vždy
+ * jedna bunka a návštevy sú nulové), v sieti je teda len 5 rôznych váh.
+ * Dijkstrov algoritmus preto vystačí s jedným FIFO frontom na materiál:
+ * bunky sa uzatvárajú v neklesajúcom poradí, takže každý front zostáva
+ * zoradený a každá bunka doň vstúpi iba raz. Výpočet je presný a lineárny;
+ * oba ciele bežia súbežne v dvoch vláknach. Po zmene cieľa sa Q-hodnoty
+ * posunú o rozdiel predvyplnení, naučené odchýlky sa zachovajú. */
+#define COST_TO_GO_TARGETS 2
+#define COST_TO_GO_WEIGHT 0.1       // Váha ceny v physical_reward
+
+typedef struct {
+    pthread_t thread;
+    int32_t target_x, target_y;
+    float *field;                   // G pre každú bunku (index x·dimension + y)
+} CostToGoWorker;
+
+int cost_to_go_enabled = 0;         // --cost-to-go
+float *cost_to_go[COST_TO_GO_TARGETS];
+int cost_to_go_seeded = -1;         // Cieľ, podľa ktorého je Q predvyplnené
+int cost_to_go_loaded = -1;         // Cieľ predvyplnenia buniek zo snapshotu (--load-q)
+int cost_to_go_next = -1;           // Cieľ pre q_seed_worker
+double cost_to_go_time = 0.0;
+
+static inline int cost_to_go_target(int32_t x, int32_t y) {
+    return (x == 0 && y == 0) ? 0 : 1;
+}
+
+void* cost_to_go_worker(void *arg) {
+    CostToGoWorker *w = (CostToGoWorker*)arg;
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    
+    double *g = (double*)malloc(cells * sizeof(double));
+    uint32_t *queue = (uint32_t*)malloc(cells * sizeof(uint32_t));
+    if (!g || !queue) {
+        printf("Chyba: Nedostatok pamäte pre pole ceny k cieľu\n");
+        exit(1);
+    }
+    
+    // Fronty materiálov ležia za sebou v jednom poli, každý má miesto pre
+    // všetky bunky svojho materiálu
+    int64_t head[5] = {0}, tail[5] = {0}, count[5] = {0};
+    for (int32_t x = 0; x < sim->dimension; x++) {
+        for (int32_t y = 0; y < sim->dimension; y++) {
+            count[cell_at(x, y)->material_id]++;
+        }
+    }
+    for (int m = 1; m < 5; m++) {
+        head[m] = tail[m] = head[m - 1] + count[m - 1];
+    }
+    for (int64_t i = 0; i < cells; i++) {
+        g[i] = INFINITY;
+    }
+    
+    // Cena vstupu do cieľa ako pri príchode od suseda
+    int32_t tx = w->target_x, ty = w->target_y;
+    int32_t from_x = tx > 0 ? tx - 1 : tx + 1;
+    int64_t target = (int64_t)tx * sim->dimension + ty;
+    int target_material = cell_at(tx, ty)->material_id;
+    g[target] = movement_cost(from_x, ty, tx, ty);
+    queue[tail[target_material]++] = (uint32_t)target;
+    
+    while (1) {
+        int best = -1;
+        for (int m = 0; m < 5; m++) {
+            if (head[m] < tail[m] && (best < 0 || g[queue[head[m]]] < g[queue[head[best]]])) {
+                best = m;
             }
         }
+        if (best < 0) break;
         
-        int direction = -1;
-        float explore_chance = agent.exploration_rate * 100.0;
+        int64_t u = queue[head[best]++];
+        int32_t ux = (int32_t)(u / sim->dimension);
+        int32_t uy = (int32_t)(u % sim->dimension);
         
-        if ((rand() % 100) < explore_chance) {
-            int possible_dirs[4];
-            int dir_count = 0;
-            
-            if (pos_y < dimension-1) possible_dirs[dir_count++] = 0;
-            if (pos_y > 0) possible_dirs[dir_count++] = 1;
-            if (pos_x < dimension-1) possible_dirs[dir_count++] = 2;
-            if (pos_x > 0) possible_dirs[dir_count++] = 3;
-            
-            if (dir_count > 0) {
-                direction = possible_dirs[rand() % dir_count];
-            }
-        } else {
-            float best_q = -INFINITY;
+        for (int d = 0; d < 4; d++) {
+            if (!move_valid(ux, uy, d)) continue;
+            int32_t vx = ux + move_dx[d];
+            int32_t vy = uy + move_dy[d];
+            int64_t v = (int64_t)vx * sim->dimension + vy;
+            if (g[v] != INFINITY) continue;
             
-            for (int d = 0; d < 4; d++) {
-                int32_t nx = pos_x, ny = pos_y;
-                int valid = 1;
-                
-                switch(d) {
-                    case 0: if (pos_y < dimension-1) ny++; else valid = 0; break;
-                    case 1: if (pos_y > 0) ny--; else valid = 0; break;
-                    case 2: if (pos_x < dimension-1) nx++; else valid = 0; break;
-                    case 3: if (pos_x > 0) nx--; else valid = 0; break;
-                }
-                
-                if (!valid) continue;
-                
-                float q_val = 0.0;
-                pthread_mutex_lock(&memory[pos_x][pos_y].mutex);
-                q_val = memory[pos_x][pos_y].q_values[d];
-                pthread_mutex_unlock(&memory[pos_x][pos_y].mutex);
-                
-                if (q_val > best_q) {
-                    best_q = q_val;
-                    direction = d;
-                }
-            }
+            g[v] = g[u] + movement_cost(ux, uy, vx, vy);
+            queue[tail[cell_at(vx, vy)->material_id]++] = (uint32_t)v;
         }
+    }
+    
+    for (int64_t i = 0; i < cells; i++) {
+        w->field[i] = (float)g[i];
+    }
+    free(queue);
+    free(g);
+    
+    return NULL;
+}
+
+/* Q(s,a) += -w·(G_nové(s_a) - G_staré(s_a)) pre bloky stĺpcov. Pri prvom
+ * predvyplnení po --load-q majú bunky snapshotu za sebou pole cieľa, podľa
+ * ktorého boli predvyplnené v behu, ktorý ich uložil, a posunú sa iba o rozdiel */
+void* q_seed_worker(void *arg) {
+    WorldInitWorker *w = (WorldInitWorker*)arg;
+    const float *next_field = cost_to_go[cost_to_go_next];
+    const float *previous_field = cost_to_go_seeded >= 0 ? cost_to_go[cost_to_go_seeded] : NULL;
+    const float *loaded_field = (cost_to_go_seeded < 0 && cost_to_go_loaded >= 0) ?
+                                cost_to_go[cost_to_go_loaded] : NULL;
+    
+    for (int32_t b = w->first_block; b * INIT_BLOCK_COLUMNS < sim->dimension; b += w->block_stride) {
+        int32_t x_end = (b + 1) * INIT_BLOCK_COLUMNS;
+        if (x_end > sim->dimension) x_end = sim->dimension;
         
-        if (direction == -1) {
-            agent.steps++;
-            continue;
+        for (int32_t x = b * INIT_BLOCK_COLUMNS; x < x_end; x++) {
+            for (int32_t y = 0; y < sim->dimension; y++) {
+                const float *base_field = previous_field;
+                if (loaded_field && sim->memory[cell_index(x, y)].evaluations > 0) base_field = loaded_field;
+                for (int d = 0; d < 4; d++) {
+                    if (!move_valid(x, y, d)) continue;
+                    int64_t v = (int64_t)(x + move_dx[d]) * sim->dimension + (y + move_dy[d]);
+                    float shift = next_field[v] - (base_field ? base_field[v] : 0.0f);
+                    atomic_add_float(&cell_q(x, y)[d], -COST_TO_GO_WEIGHT * shift);
+                }
+            }
         }
-        
-        agent.decisions_made++;
-        
-        int32_t new_x = pos_x, new_y = pos_y;
-        
-        switch(direction) {
-            case 0: new_y++; break;
-            case 1: new_y--; break;
-            case 2: new_x++; break;
-            case 3: new_x--; break;
+    }
+    
+    return NULL;
+}
+
+/* Predvyplní (alebo presunie) Q-hodnoty na cieľ [x,y] */
+void cost_to_go_seed(int32_t x, int32_t y) {
+    int target = cost_to_go_target(x, y);
+    if (target == cost_to_go_seeded) return;
+    
+    cost_to_go_next = target;
+    run_column_workers(q_seed_worker);
+    cost_to_go_seeded = target;
+    if (sim->quantum_incremental) quantum_rebuild();
+}
+
+void init_cost_to_go() {
+    double start = wall_time();
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    if (cells > UINT32_MAX) {
+        printf("Chyba: Pole ceny k cieľu podporuje najviac 2^32 buniek\n");
+        exit(1);
+    }
+    
+    CostToGoWorker workers[COST_TO_GO_TARGETS] = {
+        {.target_x = 0, .target_y = 0},
+        {.target_x = sim->dimension - 1, .target_y = sim->dimension - 1}
+    };
+    for (int t = 0; t < COST_TO_GO_TARGETS; t++) {
+        cost_to_go[t] = (float*)malloc(cells * sizeof(float));
+        if (!cost_to_go[t]) {
+            printf("Chyba: Nedostatok pamäte pre pole ceny k cieľu\n");
+            exit(1);
         }
-        
-        if (new_x < 0 || new_x >= dimension || new_y < 0 || new_y >= dimension) {
-            agent.steps++;
-            continue;
+        workers[t].field = cost_to_go[t];
+        simulation_thread_create(&workers[t].thread, cost_to_go_worker, &workers[t]);
+    }
+    for (int t = 0; t < COST_TO_GO_TARGETS; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    
+    cost_to_go_seeded = -1;
+    cost_to_go_seed(sim->target_x, sim->target_y);
+    cost_to_go_time = wall_time() - start;
+    
+    int64_t start_cell = (int64_t)sim->start_x * sim->dimension + sim->start_y;
+    if (!sim->quiet) {
+        printf("Cena k cieľom: %.3f s (2 vlákna), zo štartu domov %.3e, do baru %.3e\n",
+               cost_to_go_time, cost_to_go[0][start_cell], cost_to_go[1][start_cell]);
+    }
+}
+
+/* ==================== PARALELNÝ PLÁNOVAČ ==================== */
+
+/* S --lookahead sa rozhodnutie bez explorácie neberie iba z Q-hodnôt
+ * susedných smerov. Každý povolený smer sa ohodnotí rolloutmi hĺbky
+ * MEMORY_DEPTH: diskontovaný súčet physical_reward a na konci najväčšia
+ * Q-hodnota. Prvý rollout pokračuje hltavo (odmena + γ·max Q), ďalšie
+ * náhodne, kým ich nie je LOOKAHEAD_ROLLOUTS alebo nevyprší rozpočet
+ * rozhodnutia. Smery sa delia medzi NUM_THREADS trvalých vlákien; hlavné
+ * vlákno medzitým čaká, takže svet a pamäť sa počas plánovania iba čítajú.
+ * Kým rozpočet nevyprší, je výber deterministický pre daný seed. */
+#define LOOKAHEAD_ROLLOUTS 32
+
+typedef struct {
+    int direction;              // Prvý krok rolloutov
+    uint64_t rng;               // Stav generátora náhodných rolloutov
+    float value;                // Najlepší nájdený rollout
+    int32_t rollouts;
+} PlanTask;
+
+typedef struct {
+    pthread_t threads[NUM_THREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    PlanTask tasks[4];
+    int32_t task_count;
+    int32_t next_task;          // Prvá nepridelená úloha
+    int32_t pending;            // Nedokončené úlohy
+    int shutdown;
+    int32_t origin_x, origin_y;
+    double deadline;            // wall_time(), po ktorom sa nezačne ďalší rollout
+} Planner;
+
+Planner planner = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .work_ready = PTHREAD_COND_INITIALIZER,
+    .work_done = PTHREAD_COND_INITIALIZER
+};
+int lookahead_enabled = 0;          // --lookahead
+double lookahead_budget = 1.0e-3;   // --plan-ms: rozpočet rozhodnutia [s]
+int64_t lookahead_decisions = 0;
+double lookahead_time_total = 0.0;
+double lookahead_time_max = 0.0;
+
+int rollout_greedy_direction(int32_t x, int32_t y) {
+    int best_direction = -1;
+    float best_value = -INFINITY;
+    
+    for (int d = 0; d < 4; d++) {
+        if (!move_valid(x, y, d)) continue;
+        int32_t nx = x + move_dx[d];
+        int32_t ny = y + move_dy[d];
+        float value = physical_reward(x, y, nx, ny) +
+                      sim->agent.discount_factor * q_max_future(cell_q(nx, ny));
+        if (value > best_value) {
+            best_value = value;
+            best_direction = d;
         }
+    }
+    return best_direction;
+}
+
+int rollout_random_direction(int32_t x, int32_t y, uint64_t *rng) {
+    int possible_dirs[4];
+    int dir_count = 0;
+    
+    for (int d = 0; d < 4; d++) {
+        if (move_valid(x, y, d)) possible_dirs[dir_count++] = d;
+    }
+    return possible_dirs[splitmix64(rng) % dir_count];
+}
+
+/* Hodnota jedného rolloutu z planner.origin cez task->direction */
+float plan_rollout(PlanTask *task, int greedy) {
+    int32_t path_x[MEMORY_DEPTH + 1], path_y[MEMORY_DEPTH + 1];
+    int32_t x = planner.origin_x;
+    int32_t y = planner.origin_y;
+    path_x[0] = x;
+    path_y[0] = y;
+    
+    float value = 0.0;
+    float discount = 1.0;
+    int direction = task->direction;
+    
+    for (int depth = 0; depth < MEMORY_DEPTH; depth++) {
+        if (depth > 0) {
+            direction = greedy ? rollout_greedy_direction(x, y)
+                               : rollout_random_direction(x, y, &task->rng);
+        }
+        int32_t nx = x + move_dx[direction];
+        int32_t ny = y + move_dy[direction];
+        float reward = physical_reward(x, y, nx, ny);
         
-        int32_t old_x = pos_x, old_y = pos_y;
-        pos_x = new_x;
-        pos_y = new_y;
-        agent.steps++;
-        
-        world[pos_x][pos_y].visits++;
-        world[pos_x][pos_y].temperature += 0.1;
-        
-        float energy_cost = movement_cost(old_x, old_y, pos_x, pos_y);
-        agent.total_energy_cost += energy_cost;
-        metrics.total_energy_used += energy_cost * ENERGY_UNIT;
-        
-        float info_gain = (world[pos_x][pos_y].visits == 1) ? 1.0 : 0.1;
-        agent.total_information += info_gain;
-        world[pos_x][pos_y].information_density += info_gain / (CELL_SIZE * CELL_SIZE);
+        // Bonus za nenavštívenú bunku sa v rollouti započíta iba raz
+        if (cell_at(nx, ny)->visits == 0) {
+            for (int k = 0; k <= depth; k++) {
+                if (path_x[k] == nx && path_y[k] == ny) {
+                    reward -= 10.0 * ENERGY_UNIT;
+                    break;
+                }
+            }
+        }
         
-        float reward = physical_reward(old_x, old_y, pos_x, pos_y);
+        value += discount * reward;
+        discount *= sim->agent.discount_factor;
+        x = nx;
+        y = ny;
+        path_x[depth + 1] = x;
+        path_y[depth + 1] = y;
+    }
+    
+    return value + discount * q_max_future(cell_q(x, y));
+}
+
+void plan_task_run(PlanTask *task) {
+    task->value = plan_rollout(task, 1);
+    task->rollouts = 1;
+    
+    while (task->rollouts < LOOKAHEAD_ROLLOUTS && wall_time() < planner.deadline) {
+        float value = plan_rollout(task, 0);
+        if (value > task->value) task->value = value;
+        task->rollouts++;
+    }
+}
+
+void* planner_worker(void *arg) {
+    (void)arg;
+    
+    pthread_mutex_lock(&planner.mutex);
+    while (1) {
+        while (!planner.shutdown && planner.next_task >= planner.task_count) {
+            pthread_cond_wait(&planner.work_ready, &planner.mutex);
+        }
+        if (planner.shutdown) break;
         
-        pthread_mutex_lock(&memory[old_x][old_y].mutex);
-        float old_q = memory[old_x][old_y].q_values[direction];
-        float max_future_q = 0.0;
+        PlanTask *task = &planner.tasks[planner.next_task++];
+        pthread_mutex_unlock(&planner.mutex);
+        plan_task_run(task);
+        pthread_mutex_lock(&planner.mutex);
         
-        for (int d = 0; d < 4; d++) {
-            if (memory[pos_x][pos_y].q_values[d] > max_future_q) {
-                max_future_q = memory[pos_x][pos_y].q_values[d];
+        if (--planner.pending == 0) {
+            pthread_cond_signal(&planner.work_done);
+        }
+    }
+    pthread_mutex_unlock(&planner.mutex);
+    
+    return NULL;
+}
+
+void planner_start() {
+    planner.shutdown = 0;
+    planner.task_count = 0;
+    planner.next_task = 0;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        simulation_thread_create(&planner.threads[t], planner_worker, NULL);
+    }
+}
+
+void planner_stop() {
+    pthread_mutex_lock(&planner.mutex);
+    planner.shutdown = 1;
+    pthread_cond_broadcast(&planner.work_ready);
+    pthread_mutex_unlock(&planner.mutex);
+    
+    for (int t = 0; t < NUM_THREADS; t++) {
+        pthread_join(planner.threads[t], NULL);
+    }
+}
+
+/* Najlepší smer z [x,y] podľa rolloutov; -1, ak žiadny nie je povolený */
+int plan_direction(int32_t x, int32_t y) {
+    double start = wall_time();
+    
+    pthread_mutex_lock(&planner.mutex);
+    planner.origin_x = x;
+    planner.origin_y = y;
+    planner.deadline = start + lookahead_budget;
+    
+    int32_t count = 0;
+    for (int d = 0; d < 4; d++) {
+        if (!move_valid(x, y, d)) continue;
+        PlanTask *task = &planner.tasks[count++];
+        task->direction = d;
+        task->rng = sim->world_seed ^ (((uint64_t)sim->agent.decisions_made * 4 + d) * 0x9E3779B97F4A7C15ULL);
+    }
+    planner.task_count = count;
+    planner.next_task = 0;
+    planner.pending = count;
+    
+    pthread_cond_broadcast(&planner.work_ready);
+    while (planner.pending > 0) {
+        pthread_cond_wait(&planner.work_done, &planner.mutex);
+    }
+    pthread_mutex_unlock(&planner.mutex);
+    
+    int direction = -1;
+    float best_value = -INFINITY;
+    for (int32_t t = 0; t < count; t++) {
+        sim->agent.parallel_evals += planner.tasks[t].rollouts;
+        if (planner.tasks[t].value > best_value) {
+            best_value = planner.tasks[t].value;
+            direction = planner.tasks[t].direction;
+        }
+    }
+    
+    double elapsed = wall_time() - start;
+    lookahead_decisions++;
+    lookahead_time_total += elapsed;
+    if (elapsed > lookahead_time_max) lookahead_time_max = elapsed;
+    
+    return direction;
+}
+
+/* ==================== PRIORITIZOVANÉ ZAMETANIE ==================== */
+
+/* S --sweeping si agent zapisuje pozorované prechody (bunka, smer) →
+ * (odmena, nasledujúca bunka) do ohraničeného modelu a ich TD chybu do
+ * prioritného frontu. Vlákno na pozadí z frontu berie prechody s najväčšou
+ * chybou, prepočíta ich Q-hodnotu z modelu a do frontu pridá predchodcov
+ * zmenenej bunky - v mriežke sú to štyria susedia, ktorých pozorovaný
+ * prechod vedie do nej. Agent medzitým koná ďalej; Q-hodnoty obaja menia
+ * atomicky (pozri ATOMICKÁ PAMÄŤ Q).
+ *
+ * Model je priamo mapovaná tabuľka so seqlockom na záznam (jediný
+ * zapisovateľ je agent). Front tvorí SWEEP_BUCKETS košov podľa binárneho
+ * exponentu TD chyby; každý kôš je ohraničený kruhový front bez zámkov
+ * s viacerými producentmi (agent, plánovač) a jediným konzumentom. Plný
+ * kôš nový prechod zahodí. Záznam modelu si pamätá kôš, v ktorom jeho
+ * prechod čaká, takže prechod je vo fronte najviac raz: opakované
+ * zaradenie s rovnakou alebo menšou prioritou sa zlúči a s väčšou
+ * prechod presunie do vyššieho koša, starý výskyt sa pri výbere preskočí.
+ *
+ * Odmeny sú rádu 1e8-1e11 (movement_cost v jednotkách ENERGY_UNIT), pevný
+ * prah by preto front nikdy nevyprázdnil. Prechod sa zaradí, iba ak jeho
+ * TD chyba presiahne 2^SWEEP_TOLERANCE_EXPONENT násobok jeho odmeny.
+ * Plánovač pri prázdnom fronte najprv uvoľní procesor a po
+ * SWEEP_IDLE_POLLS prázdnych pokusoch zaspí na podmienke, ktorú agent
+ * signalizuje po zaradení prechodu, ak plánovač spí. */
+#define SWEEP_MODEL_SLOTS (1 << 18)
+#define SWEEP_BUCKETS 64
+#define SWEEP_BUCKET_SLOTS 4096
+#define SWEEP_TOLERANCE_EXPONENT (-6)  // TD chyba pod 1/64 odmeny prechodu sa nezaraďuje
+#define SWEEP_IDLE_POLLS 4             // Prázdne pokusy pred uspaním plánovača
+
+typedef struct {
+    uint32_t sequence;          // Nepárne = zápis prebieha
+    int32_t next_x, next_y;
+    float reward;
+    int32_t queued;             // Kôš, v ktorom prechod čaká, -1 = nečaká
+    int64_t key;                // bunka·4 + smer, -1 = prázdny záznam
+} ModelEntry;
+
+typedef struct {
+    uint64_t head;              // Mení iba konzument
+    uint64_t tail;              // Rezervácie producentov (CAS)
+    uint64_t slots[SWEEP_BUCKET_SLOTS];  // kľúč + 1, 0 = neobsadené
+} SweepBucket;
+
+ModelEntry *sweep_model = NULL;
+SweepBucket *sweep_queue = NULL;
+pthread_t sweep_thread;
+int sweeping_enabled = 0;       // --sweeping
+int sweep_stop = 0;
+pthread_mutex_t sweep_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t sweep_wakeup = PTHREAD_COND_INITIALIZER;
+int sweep_sleeping = 0;         // Plánovač čaká na sweep_wakeup
+int64_t sweep_updates = 0;      // Zálohy vykonané plánovačom
+int64_t sweep_dropped = 0;      // Prechody zahodené pri plnom koši
+int64_t sweep_merged = 0;       // Zaradenia zlúčené s prechodom, ktorý už čaká
+int64_t sweep_sleeps = 0;       // Uspania plánovača pri prázdnom fronte
+double sweep_time = 0.0;        // Čas behu plánovača [s]
+
+static inline int64_t sweep_key(int32_t x, int32_t y, int direction) {
+    return ((int64_t)x * sim->dimension + y) * 4 + direction;
+}
+
+static inline ModelEntry* sweep_model_entry(int64_t key) {
+    return &sweep_model[(uint64_t)(key * 0x9E3779B97F4A7C15ULL) >> 46];
+}
+
+/* Zápis pozorovaného prechodu do modelu (iba vlákno agenta) */
+void sweep_model_store(int64_t key, float reward, int32_t next_x, int32_t next_y) {
+    ModelEntry *e = sweep_model_entry(key);
+    uint32_t sequence = e->sequence;
+    
+    __atomic_store_n(&e->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    // Výskyt predošlého kľúča vo fronte sa pri výbere preskočí
+    if (__atomic_load_n(&e->key, __ATOMIC_RELAXED) != key) {
+        __atomic_store_n(&e->queued, -1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&e->key, key, __ATOMIC_RELAXED);
+    __atomic_store(&e->reward, &reward, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->next_x, next_x, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->next_y, next_y, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/* Konzistentné čítanie prechodu; 0, ak ho model nepozná */
+int sweep_model_load(int64_t key, float *reward, int32_t *next_x, int32_t *next_y) {
+    ModelEntry *e = sweep_model_entry(key);
+    uint32_t before, after;
+    int64_t stored_key;
+    
+    do {
+        before = __atomic_load_n(&e->sequence, __ATOMIC_ACQUIRE);
+        stored_key = __atomic_load_n(&e->key, __ATOMIC_RELAXED);
+        __atomic_load(&e->reward, reward, __ATOMIC_RELAXED);
+        *next_x = __atomic_load_n(&e->next_x, __ATOMIC_RELAXED);
+        *next_y = __atomic_load_n(&e->next_y, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&e->sequence, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+    
+    return stored_key == key;
+}
+
+/* Zaradenie prechodu, ktorý model pozná, s TD chybou td_error */
+void sweep_push(int64_t key, float td_error, float reward) {
+    if (!(fabsf(td_error) > ldexpf(fabsf(reward), SWEEP_TOLERANCE_EXPONENT))) return;
+    int b = ilogbf(fabsf(td_error));
+    if (b < 0) b = 0;
+    if (b >= SWEEP_BUCKETS) b = SWEEP_BUCKETS - 1;
+    
+    // Prechod čakajúci v rovnakom alebo vyššom koši stačí
+    ModelEntry *e = sweep_model_entry(key);
+    int32_t queued = __atomic_load_n(&e->queued, __ATOMIC_RELAXED);
+    do {
+        if (queued >= b) {
+            __atomic_fetch_add(&sweep_merged, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&e->queued, &queued, b, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    
+    SweepBucket *bucket = &sweep_queue[b];
+    uint64_t tail = __atomic_load_n(&bucket->tail, __ATOMIC_RELAXED);
+    do {
+        if (tail - __atomic_load_n(&bucket->head, __ATOMIC_ACQUIRE) >= SWEEP_BUCKET_SLOTS) {
+            // Prípadný starší výskyt v nižšom koši zostáva platný
+            int32_t expected = b;
+            __atomic_compare_exchange_n(&e->queued, &expected, queued, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&sweep_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&bucket->tail, &tail, tail + 1, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    
+    __atomic_store_n(&bucket->slots[tail % SWEEP_BUCKET_SLOTS], (uint64_t)key + 1, __ATOMIC_RELEASE);
+}
+
+/* Prechod s najväčšou TD chybou; -1, ak je front prázdny (iba konzument).
+ * Výskyt, ktorý záznam modelu už neeviduje (prechod sa presunul do vyššieho
+ * koša, bol vybraný skôr alebo ho vytlačil iný kľúč), sa preskočí. */
+int64_t sweep_pop() {
+    for (int b = SWEEP_BUCKETS - 1; b >= 0; b--) {
+        SweepBucket *bucket = &sweep_queue[b];
+        uint64_t head;
+        while (1) {
+            head = bucket->head;
+            uint64_t *slot = &bucket->slots[head % SWEEP_BUCKET_SLOTS];
+            uint64_t value = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+            
+            // Rezervovaný, ale ešte nezapísaný slot sa berie ako prázdny kôš
+            if (value == 0) break;
+            __atomic_store_n(slot, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&bucket->head, head + 1, __ATOMIC_RELEASE);
+            
+            int64_t key = (int64_t)(value - 1);
+            int32_t expected = b;
+            if (__atomic_compare_exchange_n(&sweep_model_entry(key)->queued, &expected, -1, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return key;
             }
         }
+    }
+    return -1;
+}
+
+static inline float sweep_td_error(int32_t x, int32_t y, int direction, float reward,
+                                   int32_t next_x, int32_t next_y) {
+    return reward + sim->agent.discount_factor * q_max_future(cell_q(next_x, next_y)) -
+           q_load(&cell_q(x, y)[direction]);
+}
+
+/* Záloha jedného prechodu z modelu a zaradenie predchodcov jeho bunky */
+void sweep_backup(int64_t key) {
+    float reward;
+    int32_t next_x, next_y;
+    if (!sweep_model_load(key, &reward, &next_x, &next_y)) return;
+    
+    int direction = (int)(key % 4);
+    int32_t x = (int32_t)(key / 4 / sim->dimension);
+    int32_t y = (int32_t)(key / 4 % sim->dimension);
+    q_td_update(&cell_q(x, y)[direction], reward, q_max_future(cell_q(next_x, next_y)));
+    sweep_updates++;
+    
+    for (int d = 0; d < 4; d++) {
+        int32_t px = x - move_dx[d];
+        int32_t py = y - move_dy[d];
+        if (px < 0 || px >= sim->dimension || py < 0 || py >= sim->dimension) continue;
         
-        float new_q = old_q + agent.learning_rate * 
-                     (reward + agent.discount_factor * max_future_q - old_q);
+        int64_t predecessor = sweep_key(px, py, d);
+        float predecessor_reward;
+        int32_t px_next, py_next;
+        if (!sweep_model_load(predecessor, &predecessor_reward, &px_next, &py_next)) continue;
+        if (px_next != x || py_next != y) continue;
         
-        memory[old_x][old_y].q_values[direction] = new_q;
-        memory[old_x][old_y].cumulative_reward += reward;
-        memory[old_x][old_y].last_visit = agent.steps;
-        if (reward > 0) memory[old_x][old_y].successful_exits++;
-        memory[old_x][old_y].evaluations++;
-        pthread_mutex_unlock(&memory[old_x][old_y].mutex);
+        sweep_push(predecessor, sweep_td_error(px, py, d, predecessor_reward, x, y),
+                   predecessor_reward);
+    }
+}
+
+/* Uspí plánovač, kým agent nezaradí prechod alebo beh neskončí. Príznak
+ * sa nastaví pred poslednou kontrolou frontu a agent ho číta až po zápise
+ * do frontu (obaja cez úplnú bariéru), takže prebudenie sa nestratí.
+ * Vráti kľúč z poslednej kontroly alebo -1. */
+int64_t sweep_wait() {
+    pthread_mutex_lock(&sweep_mutex);
+    __atomic_store_n(&sweep_sleeping, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    
+    int64_t key = sweep_pop();
+    if (key < 0) sweep_sleeps++;
+    while (key < 0 && __atomic_load_n(&sweep_sleeping, __ATOMIC_RELAXED) &&
+           !__atomic_load_n(&sweep_stop, __ATOMIC_ACQUIRE)) {
+        pthread_cond_wait(&sweep_wakeup, &sweep_mutex);
+    }
+    
+    __atomic_store_n(&sweep_sleeping, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&sweep_mutex);
+    return key;
+}
+
+void sweep_wake() {
+    pthread_mutex_lock(&sweep_mutex);
+    __atomic_store_n(&sweep_sleeping, 0, __ATOMIC_RELAXED);
+    pthread_cond_signal(&sweep_wakeup);
+    pthread_mutex_unlock(&sweep_mutex);
+}
+
+void* sweep_worker(void *arg) {
+    (void)arg;
+    double start = wall_time();
+    int idle_polls = 0;
+    
+    while (!__atomic_load_n(&sweep_stop, __ATOMIC_ACQUIRE)) {
+        int64_t key = sweep_pop();
+        if (key < 0) {
+            if (++idle_polls < SWEEP_IDLE_POLLS) {
+                sched_yield();
+                continue;
+            }
+            idle_polls = 0;
+            key = sweep_wait();
+            if (key < 0) continue;
+        }
+        idle_polls = 0;
+        sweep_backup(key);
+    }
+    
+    sweep_time = wall_time() - start;
+    return NULL;
+}
+
+/* Volá agent po skutočnom kroku z [x,y] smerom direction */
+void sweep_observe(int32_t x, int32_t y, int direction, float reward, int32_t next_x, int32_t next_y) {
+    int64_t key = sweep_key(x, y, direction);
+    sweep_model_store(key, reward, next_x, next_y);
+    sweep_push(key, sweep_td_error(x, y, direction, reward, next_x, next_y), reward);
+    
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sweep_sleeping, __ATOMIC_RELAXED)) sweep_wake();
+}
+
+void sweep_start() {
+    sweep_model = (ModelEntry*)malloc(SWEEP_MODEL_SLOTS * sizeof(ModelEntry));
+    sweep_queue = (SweepBucket*)calloc(SWEEP_BUCKETS, sizeof(SweepBucket));
+    if (!sweep_model || !sweep_queue) {
+        printf("Chyba: Nedostatok pamäte pre model plánovača\n");
+        exit(1);
+    }
+    for (int32_t i = 0; i < SWEEP_MODEL_SLOTS; i++) {
+        sweep_model[i].sequence = 0;
+        sweep_model[i].queued = -1;
+        sweep_model[i].key = -1;
+    }
+    
+    sweep_stop = 0;
+    sweep_sleeping = 0;
+    simulation_thread_create(&sweep_thread, sweep_worker, NULL);
+}
+
+void sweep_finish() {
+    __atomic_store_n(&sweep_stop, 1, __ATOMIC_RELEASE);
+    sweep_wake();
+    pthread_join(sweep_thread, NULL);
+    free(sweep_model);
+    free(sweep_queue);
+}
+
+/* ==================== HLAVNÁ SIMULÁCIA ==================== */
+
+void finalize_metrics();
+
+/* Beh agenta po krokoch - program ho dobehne naraz, knižnica po dávkach */
+typedef struct {
+    int32_t pos_x, pos_y;
+    double run_start;
+    int32_t last_print;
+    int finished;
+} SimulationRun;
+
+void simulation_begin(SimulationRun *run) {
+    run->pos_x = sim->start_x;
+    run->pos_y = sim->start_y;
+    run->run_start = wall_time();
+    run->last_print = 0;
+    run->finished = 0;
+    
+    if (!sim->quiet) {
+        printf("\n[KYBERNAUT-HUMAN v3.1] Fyzikálne korektná simulácia\n");
+        printf("=====================================================\n");
+        printf("Projekcia 3D→2D:\n");
+        printf("  • Bunka: %.1e m\n", CELL_SIZE);
+        printf("  • Časový krok: %.1e s\n", TIME_STEP);
+        printf("  • Energetická jednotka: %.1e J\n", ENERGY_UNIT);
+        printf("  • Rozmer sveta: %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
+        printf("=====================================================\n");
+    }
+    
+    if (lookahead_enabled) {
+        if (!sim->quiet) printf("Plánovač: %d vlákien, hĺbka %d, max %d rolloutov na smer, rozpočet %.2f ms\n",
+                           NUM_THREADS, MEMORY_DEPTH, LOOKAHEAD_ROLLOUTS, lookahead_budget * 1000.0);
+        planner_start();
+    }
+    if (sweeping_enabled) {
+        if (!sim->quiet) printf("Zametanie: model %d prechodov, %d košov priority po %d\n",
+                           SWEEP_MODEL_SLOTS, SWEEP_BUCKETS, SWEEP_BUCKET_SLOTS);
+        sweep_start();
+    }
+}
+
+/* Jeden krok agenta; vráti 0, keď beh skončil (misia alebo MAX_STEPS) */
+int simulation_step(SimulationRun *run) {
+    if (sim->agent.steps >= MAX_STEPS) return 0;
+    
+    int32_t pos_x = run->pos_x;
+    int32_t pos_y = run->pos_y;
+    
+    // Bunky sa dochladia lenivo pri ďalšom prístupe
+    if (sim->agent.steps % COOLING_INTERVAL == 0) {
+        cool_world();
+    }
+    
+    int direction = -1;
+    float explore_chance = sim->agent.exploration_rate * 100.0;
+    
+    if ((explore_rand() % 100) < explore_chance) {
+        int possible_dirs[4];
+        int dir_count = 0;
         
-        agent.learning_entropy += agent.computational_cost / 293.15;
+        if (pos_y < sim->dimension-1) possible_dirs[dir_count++] = 0;
+        if (pos_y > 0) possible_dirs[dir_count++] = 1;
+        if (pos_x < sim->dimension-1) possible_dirs[dir_count++] = 2;
+        if (pos_x > 0) possible_dirs[dir_count++] = 3;
         
-        if (agent.path_index < MAX_STEPS) {
-            agent.path[agent.path_index++] = direction;
+        if (dir_count > 0) {
+            direction = possible_dirs[explore_rand() % dir_count];
         }
+    } else if (lookahead_enabled) {
+        direction = plan_direction(pos_x, pos_y);
+    } else if (sim->linear_enabled) {
+        float q[4];
+        linear_q_values(pos_x, pos_y, q);
+        direction = q_argmax(q, pos_x, pos_y);
+    } else {
+        direction = q_argmax(cell_q(pos_x, pos_y), pos_x, pos_y);
+    }
+    
+    if (direction == -1) {
+        sim->agent.steps++;
+        return 1;
+    }
+    
+    sim->agent.decisions_made++;
+    
+    int32_t new_x = pos_x, new_y = pos_y;
+    
+    switch(direction) {
+        case 0: new_y++; break;
+        case 1: new_y--; break;
+        case 2: new_x++; break;
+        case 3: new_x--; break;
+    }
+    
+    if (new_x < 0 || new_x >= sim->dimension || new_y < 0 || new_y >= sim->dimension) {
+        sim->agent.steps++;
+        return 1;
+    }
+    
+    int32_t old_x = pos_x, old_y = pos_y;
+    pos_x = new_x;
+    pos_y = new_y;
+    run->pos_x = pos_x;
+    run->pos_y = pos_y;
+    sim->agent.steps++;
+    
+    float temperature = node_temperature(pos_x, pos_y);
+    Cell *cell = cell_at(pos_x, pos_y);
+    if (cell->visits == 0) {
+        metrics_first_visit(cell, temperature);
+    }
+    cell->visits++;
+    cell->temperature += 0.1;
+    sim->visited_heat += 0.1;
+    
+    float energy_cost = movement_cost(old_x, old_y, pos_x, pos_y);
+    sim->agent.total_energy_cost += energy_cost;
+    sim->metrics.total_energy_used += energy_cost * ENERGY_UNIT;
+    
+    float info_gain = (cell->visits == 1) ? 1.0 : 0.1;
+    sim->agent.total_information += info_gain;
+    cell->information_density += info_gain / (CELL_SIZE * CELL_SIZE);
+    
+    float reward = physical_reward(old_x, old_y, pos_x, pos_y);
+    
+    if (sim->linear_enabled) {
+        linear_update(old_x, old_y, direction, linear_reward(old_x, old_y, pos_x, pos_y),
+                      linear_q_max(pos_x, pos_y));
+    } else {
+        float max_future_q = q_max_future(cell_q(pos_x, pos_y));
+        memory_record_transition(old_x, old_y, direction, reward,
+                                 max_future_q, sim->agent.steps);
+    }
+    if (sweeping_enabled) {
+        sweep_observe(old_x, old_y, direction, reward, pos_x, pos_y);
+    }
+    
+    sim->agent.learning_entropy += sim->agent.computational_cost / 293.15;
+    
+    if (sim->agent.path_index < MAX_STEPS) {
+        sim->agent.path[sim->agent.path_index++] = direction;
+    }
+    
+    if (sim->agent.steps % 200 == 0 && sim->agent.steps > 0) {
+        float current_efficiency = (sim->agent.total_energy_cost > 0) ? 
+                                   sim->agent.steps / sim->agent.total_energy_cost : 0;
         
-        if (agent.steps % 200 == 0 && agent.steps > 0) {
-            float current_efficiency = (agent.total_energy_cost > 0) ? 
-                                       agent.steps / agent.total_energy_cost : 0;
-            
-            if (current_efficiency < agent.efficiency_history[agent.efficiency_index % 100] * 0.9) {
-                agent.exploration_rate = fmin(0.7, agent.exploration_rate * 1.2);
-            } else {
-                agent.exploration_rate = fmax(0.05, agent.exploration_rate * 0.9);
-            }
-            
-            agent.efficiency_history[agent.efficiency_index % 100] = current_efficiency;
-            agent.efficiency_index++;
+        if (current_efficiency < sim->agent.efficiency_history[sim->agent.efficiency_index % 100] * 0.9) {
+            sim->agent.exploration_rate = fmin(0.7, sim->agent.exploration_rate * 1.2);
+        } else {
+            sim->agent.exploration_rate = fmax(0.05, sim->agent.exploration_rate * 0.9);
         }
         
-        if (agent.steps - last_print >= 1000) {
-            float info_entropy = calculate_information_entropy();
-            float therm_entropy = calculate_thermal_entropy();
-            float quantum_entropy = calculate_quantum_entropy();
-            
-            printf("Krok %5"PRId32": [%3"PRId32",%3"PRId32"] %s\n", 
-                   agent.steps, pos_x, pos_y, 
-                   materials[world[pos_x][pos_y].material_id].name);
-            printf("         Teplota: %.1fK | Návštev: %"PRId32"\n",
-                   world[pos_x][pos_y].temperature, world[pos_x][pos_y].visits);
-            printf("         Energia: %.1e J | ε: %.2f\n",
-                   agent.total_energy_cost * ENERGY_UNIT, agent.exploration_rate);
-            printf("         Entropia: S_info=%.3f, S_therm=%.3f, S_quant=%.3f\n",
-                   info_entropy, therm_entropy, quantum_entropy);
-            
-            last_print = agent.steps;
-        }
+        sim->agent.efficiency_history[sim->agent.efficiency_index % 100] = current_efficiency;
+        sim->agent.efficiency_index++;
+    }
+    
+    // Priebeh aj s entropiami iba pre výpis - v tichom režime odpadá
+    if (!sim->quiet && sim->agent.steps - run->last_print >= 1000) {
+        float info_entropy = calculate_information_entropy();
+        float therm_entropy = calculate_thermal_entropy();
+        float quantum_entropy = calculate_quantum_entropy();
         
-        if (world[pos_x][pos_y].is_target == 1 && !agent.home_reached) {
-            agent.home_reached = agent.steps;
+        printf("Krok %5"PRId32": [%3"PRId32",%3"PRId32"] %s\n", 
+               sim->agent.steps, pos_x, pos_y, 
+               materials[cell->material_id].name);
+        printf("         Teplota: %.1fK | Návštev: %"PRId32"\n",
+               node_temperature(pos_x, pos_y), cell->visits);
+        printf("         Energia: %.1e J | ε: %.2f\n",
+               sim->agent.total_energy_cost * ENERGY_UNIT, sim->agent.exploration_rate);
+        printf("         Entropia: S_info=%.3f, S_therm=%.3f, S_quant=%.3f\n",
+               info_entropy, therm_entropy, quantum_entropy);
+        
+        run->last_print = sim->agent.steps;
+    }
+    
+    if (cell->is_target == 1 && !sim->agent.home_reached) {
+        sim->agent.home_reached = sim->agent.steps;
+        sim->home_time = wall_time() - run->run_start;
+        if (!sim->quiet) {
             printf("\n╔══════════════════════════════════════════════════╗\n");
-            printf("║   [DOMOV DOSIAHNUTÝ] v kroku %"PRId32"!                ║\n", agent.steps);
+            printf("║   [DOMOV DOSIAHNUTÝ] v kroku %"PRId32"!                ║\n", sim->agent.steps);
             printf("║   Energia: %.1e J | S_info: %.3f              ║\n",
-                   agent.total_energy_cost * ENERGY_UNIT, metrics.information_entropy);
+                   sim->agent.total_energy_cost * ENERGY_UNIT, sim->metrics.information_entropy);
             printf("╚══════════════════════════════════════════════════╝\n");
-            
-            target_x = dimension - 1;
-            target_y = dimension - 1;
-            agent.exploration_rate = 0.15;
         }
         
-        if (world[pos_x][pos_y].is_target == 2 && !agent.bar_reached) {
-            agent.bar_reached = agent.steps;
+        sim->target_x = sim->dimension - 1;
+        sim->target_y = sim->dimension - 1;
+        sim->agent.exploration_rate = 0.15;
+        if (cost_to_go_enabled) cost_to_go_seed(sim->target_x, sim->target_y);
+    }
+    
+    if (cell->is_target == 2 && !sim->agent.bar_reached) {
+        sim->agent.bar_reached = sim->agent.steps;
+        sim->bar_time = wall_time() - run->run_start;
+        if (!sim->quiet) {
             printf("\n╔══════════════════════════════════════════════════╗\n");
-            printf("║   [BAR DOSIAHNUTÝ] v kroku %"PRId32"!                  ║\n", agent.steps);
+            printf("║   [BAR DOSIAHNUTÝ] v kroku %"PRId32"!                  ║\n", sim->agent.steps);
             printf("║   Celková energia: %.1e J                     ║\n",
-                   agent.total_energy_cost * ENERGY_UNIT);
+                   sim->agent.total_energy_cost * ENERGY_UNIT);
             printf("╚══════════════════════════════════════════════════╝\n");
-            
-            target_x = 0;
-            target_y = 0;
-            agent.exploration_rate = 0.15;
         }
         
-        if (agent.home_reached && agent.bar_reached) {
+        sim->target_x = 0;
+        sim->target_y = 0;
+        sim->agent.exploration_rate = 0.15;
+        if (cost_to_go_enabled) cost_to_go_seed(sim->target_x, sim->target_y);
+    }
+    
+    if (sim->agent.home_reached && sim->agent.bar_reached) {
+        if (!sim->quiet) {
             printf("\n╔══════════════════════════════════════════════════╗\n");
             printf("║        MISIA UKONČENÁ - OBA CIEE DOSIAHNUTÉ!    ║\n");
             printf("║   Fyzikálne korektná simulácia dokončená.       ║\n");
             printf("╚══════════════════════════════════════════════════╝\n");
-            break;
         }
+        return 0;
+    }
+    
+    return 1;
+}
+
+/* Zastaví pomocné vlákna a spočíta záverečné metriky; opakované volanie nič nerobí */
+void simulation_finish(SimulationRun *run) {
+    if (run->finished) return;
+    run->finished = 1;
+    
+    if (lookahead_enabled) {
+        planner_stop();
+    }
+    if (sweeping_enabled) {
+        sweep_finish();
     }
     
+    finalize_metrics();
+}
+
+void run_simulation() {
+    SimulationRun run;
+    simulation_begin(&run);
+    while (simulation_step(&run)) {
+    }
+    simulation_finish(&run);
+}
+
+/* Záverečné entropie a metriky po behu simulácie */
+void finalize_metrics() {
     calculate_information_entropy();
     calculate_thermal_entropy();
     calculate_quantum_entropy();
     
-    int64_t visited = 0;
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            if (world[x][y].visits > 0) visited++;
+    sim->metrics.coverage = (float)sim->metrics.visited_cells / sim->metrics.total_cells * 100.0;
+    
+    if (sim->metrics.total_energy_used > 0) {
+        sim->metrics.information_efficiency = sim->agent.total_information / sim->metrics.total_energy_used;
+    }
+    
+    sim->metrics.average_temperature = world_heat() / sim->metrics.total_cells;
+    
+    float delta_S = sim->metrics.thermal_entropy - sim->metrics.information_entropy;
+    if (sim->agent.total_energy_cost > 0) {
+        sim->metrics.learning_efficiency = delta_S / sim->agent.total_energy_cost;
+    }
+}
+
+/* ==================== HOGWILD UČENIE ==================== */
+
+/* S --agents K beží K agentov na K vláknach, každý s vlastnou polohou,
+ * generátorom a mierou explorácie (rozložené okolo počiatočnej). Všetci
+ * menia zdieľanú pamäť Q bez globálneho zámku cez atomické operácie
+ * z memory_record_transition. Návštevy, teplo a informačná hustota buniek
+ * sa pripočítavajú atomicky; globálne chladenie sa v tomto režime
+ * nespúšťa, pretože agenti nemajú spoločné hodiny krokov. Beh končí, keď
+ * prvý agent dosiahne oba ciele - jeho čas je čas konvergencie. */
+typedef struct {
+    pthread_t thread;
+    int32_t id;
+    int32_t x, y;
+    int32_t goal_x, goal_y;
+    int32_t steps;
+    int32_t home_reached, bar_reached;
+    double home_time, bar_time;     // Nástenný čas od štartu [s]
+    float exploration_rate;
+    uint64_t rng;
+    int64_t decisions;
+    float total_energy_cost;
+    float total_information;
+} Learner;
+
+int32_t hogwild_agents = 1;         // --agents: 1 = jeden agent ako doteraz
+int32_t hogwild_winner = -1;        // Prvý agent s oboma cieľmi
+double hogwild_start = 0.0;
+double hogwild_time = 0.0;          // Čas konvergencie alebo celého behu
+Learner *learners = NULL;
+
+/* Reakcia agenta na dosiahnutie cieľa; vráti 1, ak má oba */
+int learner_check_goals(Learner *l) {
+    int is_target = cell_at(l->x, l->y)->is_target;
+    
+    if (is_target == 1 && !l->home_reached) {
+        l->home_reached = l->steps;
+        l->home_time = wall_time() - hogwild_start;
+        l->goal_x = sim->dimension - 1;
+        l->goal_y = sim->dimension - 1;
+        l->exploration_rate = 0.15;
+        if (!sim->quiet) {
+            pthread_mutex_lock(&print_mutex);
+            printf("[Agent %2"PRId32"] Domov v kroku %"PRId32" (%.3f s)\n", l->id, l->steps, l->home_time);
+            pthread_mutex_unlock(&print_mutex);
+        }
+    } else if (is_target == 2 && !l->bar_reached) {
+        l->bar_reached = l->steps;
+        l->bar_time = wall_time() - hogwild_start;
+        l->goal_x = 0;
+        l->goal_y = 0;
+        l->exploration_rate = 0.15;
+        if (!sim->quiet) {
+            pthread_mutex_lock(&print_mutex);
+            printf("[Agent %2"PRId32"] Bar v kroku %"PRId32" (%.3f s)\n", l->id, l->steps, l->bar_time);
+            pthread_mutex_unlock(&print_mutex);
+        }
+    }
+    
+    return l->home_reached && l->bar_reached;
+}
+
+void* learner_run(void *arg) {
+    Learner *l = (Learner*)arg;
+    
+    while (l->steps < MAX_STEPS && __atomic_load_n(&hogwild_winner, __ATOMIC_RELAXED) < 0) {
+        int possible_dirs[4];
+        int dir_count = 0;
+        for (int d = 0; d < 4; d++) {
+            if (move_valid(l->x, l->y, d)) possible_dirs[dir_count++] = d;
+        }
+        
+        int direction = -1;
+        if ((splitmix64(&l->rng) % 1000) < l->exploration_rate * 1000.0) {
+            direction = possible_dirs[splitmix64(&l->rng) % dir_count];
+        } else {
+            direction = q_argmax(cell_q(l->x, l->y), l->x, l->y);
+        }
+        
+        if (direction < 0) break;
+        
+        int32_t old_x = l->x, old_y = l->y;
+        l->x += move_dx[direction];
+        l->y += move_dy[direction];
+        l->steps++;
+        l->decisions++;
+        
+        Cell *node = cell_at(l->x, l->y);
+        int32_t previous_visits = __atomic_fetch_add(&node->visits, 1, __ATOMIC_RELAXED);
+        atomic_add_float(&node->temperature, 0.1);
+        
+        l->total_energy_cost += movement_cost(old_x, old_y, l->x, l->y);
+        
+        float info_gain = (previous_visits == 0) ? 1.0 : 0.1;
+        l->total_information += info_gain;
+        atomic_add_float(&node->information_density, info_gain / (CELL_SIZE * CELL_SIZE));
+        
+        float reward = transition_reward(old_x, old_y, l->x, l->y, l->goal_x, l->goal_y,
+                                         l->home_reached, l->bar_reached);
+        memory_record_transition(old_x, old_y, direction, reward,
+                                 q_max_future(cell_q(l->x, l->y)), l->steps);
+        
+        if (l->steps % 200 == 0) {
+            l->exploration_rate = fmax(0.05, l->exploration_rate * 0.9);
+        }
+        
+        if (learner_check_goals(l)) {
+            int32_t none = -1;
+            if (__atomic_compare_exchange_n(&hogwild_winner, &none, l->id, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                hogwild_time = wall_time() - hogwild_start;
+            }
+            break;
+        }
+    }
+    
+    return NULL;
+}
+
+void run_hogwild() {
+    if (!sim->quiet) {
+        printf("\n[KYBERNAUT-HUMAN v3.1] Hogwild učenie: %"PRId32" agentov na %"PRId32" vláknach\n",
+               hogwild_agents, hogwild_agents);
+        printf("=====================================================\n");
+    }
+    
+    learners = (Learner*)calloc(hogwild_agents, sizeof(Learner));
+    if (!learners) {
+        printf("Chyba: Nedostatok pamäte pre agentov\n");
+        exit(1);
+    }
+    
+    hogwild_winner = -1;
+    hogwild_start = wall_time();
+    for (int32_t i = 0; i < hogwild_agents; i++) {
+        Learner *l = &learners[i];
+        l->id = i;
+        l->x = sim->start_x;
+        l->y = sim->start_y;
+        l->goal_x = sim->target_x;
+        l->goal_y = sim->target_y;
+        l->exploration_rate = sim->agent.exploration_rate * (0.5 + (float)i / hogwild_agents);
+        l->rng = sim->world_seed ^ ((uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL);
+        simulation_thread_create(&l->thread, learner_run, l);
+    }
+    for (int32_t i = 0; i < hogwild_agents; i++) {
+        pthread_join(learners[i].thread, NULL);
+    }
+    if (hogwild_winner < 0) {
+        hogwild_time = wall_time() - hogwild_start;
+    }
+    
+    // Súhrn do agenta: ciele víťaza (alebo najďalej postúpeného), súčty krokov
+    int32_t best = hogwild_winner;
+    if (best < 0) {
+        best = 0;
+        for (int32_t i = 1; i < hogwild_agents; i++) {
+            int goals = (learners[i].home_reached > 0) + (learners[i].bar_reached > 0);
+            int best_goals = (learners[best].home_reached > 0) + (learners[best].bar_reached > 0);
+            if (goals > best_goals) best = i;
+        }
+    }
+    sim->agent.steps = 0;
+    for (int32_t i = 0; i < hogwild_agents; i++) {
+        sim->agent.steps += learners[i].steps;
+        sim->agent.decisions_made += learners[i].decisions;
+        sim->agent.total_energy_cost += learners[i].total_energy_cost;
+        sim->agent.total_information += learners[i].total_information;
+    }
+    sim->metrics.total_energy_used = sim->agent.total_energy_cost * ENERGY_UNIT;
+    sim->agent.home_reached = learners[best].home_reached;
+    sim->home_time = learners[best].home_time;
+    sim->bar_time = learners[best].bar_time;
+    sim->agent.bar_reached = learners[best].bar_reached;
+    sim->agent.exploration_rate = learners[best].exploration_rate;
+    
+    metrics_rebuild();
+    finalize_metrics();
+}
+
+/* ==================== SNAPSHOT PAMÄTE Q ==================== */
+
+/* Binárny snapshot naučenej pamäte: hlavička (rozmer, seed sveta, kroky
+ * aj čas k cieľom behu, ktorý ho uložil, a cieľ predvyplnenia Q) a za ňou iba bunky s evaluations
+ * > 0. Q-hodnoty sú v bfloat16 - horných 16 bitov floatu so zaokrúhlením.
+ * Float16 by rozsah Q (rádovo 1e11 z movement_cost) nepokryl, bfloat16
+ * drží plný exponent s 8-bitovou mantisou. Záznam má 12 B namiesto 32 B
+ * bunky pamäte. Načítanie mapuje súbor cez mmap a Q-hodnoty rozbalí
+ * priamo z mapy bez medzibufferu. */
+#define Q_SNAPSHOT_MAGIC "KTIQSNP1"
+#define Q_SNAPSHOT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    int32_t dimension;
+    uint64_t seed;
+    uint64_t entries;
+    int32_t home_reached;       // Kroky k cieľom behu, ktorý snapshot uložil
+    int32_t bar_reached;
+    double home_time;           // Nástenný čas k cieľom toho behu [s]
+    double bar_time;
+    int32_t cost_to_go_target;  // Cieľ predvyplnenia Q + 1 (0 = bez --cost-to-go)
+    uint8_t reserved[4];
+} QSnapshotHeader;              // 64 B
+
+typedef struct {
+    uint32_t cell;              // x·dimension + y
+    uint16_t q[4];              // bfloat16
+} QSnapshotEntry;               // 12 B
+
+// Index bunky má 32 bitov - snapshot iba pre svety do 65536x65536
+#define Q_SNAPSHOT_MAX_CELLS ((uint64_t)UINT32_MAX + 1)
+
+const char *q_save_path = NULL;     // --save-q
+const char *q_load_path = NULL;     // --load-q
+QSnapshotHeader q_loaded;           // Hlavička načítaného snapshotu
+int q_warm_started = 0;
+double q_load_time = 0.0;
+
+static inline uint16_t float_to_bf16(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) return (uint16_t)((bits >> 16) | 0x40);  // NaN
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return (uint16_t)(bits >> 16);
+}
+
+static inline float bf16_to_float(uint16_t half) {
+    uint32_t bits = (uint32_t)half << 16;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Zapíše snapshot; vráti počet uložených buniek alebo -1 pri chybe */
+int64_t q_snapshot_save(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    
+    QSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, Q_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = Q_SNAPSHOT_VERSION;
+    header.dimension = sim->dimension;
+    header.seed = sim->world_seed;
+    header.home_reached = sim->agent.home_reached;
+    header.bar_reached = sim->agent.bar_reached;
+    header.home_time = sim->home_time;
+    header.bar_time = sim->bar_time;
+    header.cost_to_go_target = cost_to_go_enabled ? cost_to_go_seeded + 1 : 0;
+    fwrite(&header, sizeof(header), 1, f);
+    
+    for (int32_t x = 0; x < sim->dimension; x++) {
+        for (int32_t y = 0; y < sim->dimension; y++) {
+            size_t index = cell_index(x, y);
+            if (sim->memory[index].evaluations == 0) continue;
+            const float *q = sim->q_table[index].q_values;
+            
+            QSnapshotEntry entry;
+            entry.cell = (uint32_t)((int64_t)x * sim->dimension + y);
+            for (int d = 0; d < 4; d++) {
+                entry.q[d] = float_to_bf16(q[d]);
+            }
+            fwrite(&entry, sizeof(entry), 1, f);
+            header.entries++;
         }
     }
-    metrics.visited_cells = visited;
-    metrics.coverage = (float)visited / metrics.total_cells * 100.0;
     
-    if (metrics.total_energy_used > 0) {
-        metrics.information_efficiency = agent.total_information / metrics.total_energy_used;
+    // Počet záznamov je známy až na konci
+    fseek(f, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, f);
+    int failed = ferror(f);
+    if (fclose(f) != 0 || failed) return -1;
+    
+    return (int64_t)header.entries;
+}
+
+/* Teplý štart z snapshotu; pri chybe alebo inom svete ukončí program */
+void q_snapshot_load(const char *path) {
+    double start = wall_time();
+    
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(QSnapshotHeader)) {
+        printf("Chyba: Snapshot '%s' sa nedá otvoriť\n", path);
+        exit(1);
+    }
+    
+    void *mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Chyba: Snapshot '%s' sa nedá namapovať\n", path);
+        exit(1);
+    }
+    
+    const QSnapshotHeader *header = (const QSnapshotHeader*)mapping;
+    // Počet záznamov sa porovná s veľkosťou bez násobenia, ktoré by mohlo pretiecť
+    if (memcmp(header->magic, Q_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != Q_SNAPSHOT_VERSION ||
+        header->entries > ((size_t)st.st_size - sizeof(QSnapshotHeader)) / sizeof(QSnapshotEntry) ||
+        header->cost_to_go_target < 0 || header->cost_to_go_target > COST_TO_GO_TARGETS) {
+        printf("Chyba: '%s' nie je platný snapshot pamäte Q\n", path);
+        exit(1);
+    }
+    if (header->dimension != sim->dimension || header->seed != sim->world_seed) {
+        printf("Chyba: Snapshot patrí svetu %"PRId32"x%"PRId32" so seedom %"PRIu64
+               " (teraz %"PRId32"x%"PRId32", seed %"PRIu64")\n",
+               header->dimension, header->dimension, header->seed,
+               sim->dimension, sim->dimension, sim->world_seed);
+        exit(1);
     }
     
-    float total_temp = 0.0;
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            total_temp += world[x][y].temperature;
+    const QSnapshotEntry *entries = (const QSnapshotEntry*)(header + 1);
+    // Celý súbor sa overí pred prvým zápisom do pamäte
+    uint64_t world_cells = (uint64_t)sim->dimension * sim->dimension;
+    for (uint64_t i = 0; i < header->entries; i++) {
+        if (entries[i].cell >= world_cells) {
+            printf("Chyba: '%s' nie je platný snapshot pamäte Q (bunka %"PRIu32" mimo sveta)\n",
+                   path, entries[i].cell);
+            exit(1);
+        }
+    }
+    for (uint64_t i = 0; i < header->entries; i++) {
+        int32_t x = (int32_t)(entries[i].cell / sim->dimension);
+        int32_t y = (int32_t)(entries[i].cell % sim->dimension);
+        for (int d = 0; d < 4; d++) {
+            cell_q(x, y)[d] = bf16_to_float(entries[i].q[d]);
+        }
+        sim->memory[cell_index(x, y)].evaluations = 1;   // Bunka zostane aj v ďalšom snapshote
+    }
+    if (sim->quantum_incremental) quantum_rebuild();
+    
+    q_loaded = *header;
+    q_warm_started = 1;
+    cost_to_go_loaded = q_loaded.cost_to_go_target - 1;
+    munmap(mapping, st.st_size);
+    q_load_time = wall_time() - start;
+    
+    if (!sim->quiet) {
+        printf("Teplý štart: %"PRIu64" buniek z '%s' za %.3f ms\n",
+               q_loaded.entries, path, q_load_time * 1000.0);
+    }
+}
+
+/* Riadok porovnania kroku a času k cieľu so snapshotom */
+void print_goal_reduction(const char *goal, int32_t before_steps, double before_time,
+                          int32_t steps, double time) {
+    if (!before_steps || !steps) {
+        printf("  %s: predtým %"PRId32" krokov, teraz %"PRId32" (0 = nedosiahnutý)\n",
+               goal, before_steps, steps);
+        return;
+    }
+    printf("  %s: %"PRId32" → %"PRId32" krokov (%+.1f%%), %.3f → %.3f s\n",
+           goal, before_steps, steps, 100.0 * (steps - before_steps) / before_steps,
+           before_time, time);
+}
+
+/* Skalárny dvojprechod proti jadru; pred každým opakovaním nová epocha
+ * chladenia, aby oba výpočty videli nedochladený svet ako počas behu */
+void run_entropy_benchmark() {
+    double cells = (double)sim->dimension * sim->dimension;
+    double bytes = cells * ((size_t)1 << sim->cell_shift);
+    
+    double scalar_time = 0.0, kernel_time = 0.0;
+    float scalar = 0.0, kernel = 0.0;
+    for (int r = 0; r < BENCH_ENTROPY_REPEATS; r++) {
+        cool_world();
+        double start = wall_time();
+        scalar = calculate_thermal_entropy_scalar();
+        scalar_time += wall_time() - start;
+        
+        cool_world();
+        start = wall_time();
+        kernel = thermal_entropy_kernel();
+        kernel_time += wall_time() - start;
+    }
+    scalar_time /= BENCH_ENTROPY_REPEATS;
+    kernel_time /= BENCH_ENTROPY_REPEATS;
+    
+    printf("\nTepelná entropia %"PRId32"x%"PRId32" (%d opakovaní, %"PRId32" vlákien, jadro %s, SIMD šírka %d):\n",
+           sim->dimension, sim->dimension, BENCH_ENTROPY_REPEATS, sim->world_init_threads,
+           kernel_names[kernel_variant], kernel_width[kernel_variant]);
+    printf("  Skalárny dvojprechod: S=%.6f, %8.3f ms, %6.2f GB/s, %8.1f M buniek/s\n",
+           scalar, scalar_time * 1000.0, 2.0 * bytes / scalar_time / 1e9, cells / scalar_time / 1e6);
+    printf("  SIMD jadro:           S=%.6f, %8.3f ms, %6.2f GB/s, %8.1f M buniek/s\n",
+           kernel, kernel_time * 1000.0, bytes / kernel_time / 1e9, cells / kernel_time / 1e6);
+    printf("  Zrýchlenie: %.1fx, rozdiel entropie %.2e\n",
+           scalar_time / kernel_time, fabs(scalar - kernel));
+}
+
+/* ==================== REPLIKÁTY A ŠTATISTIKA ==================== */
+
+/* Jeden replikát: svet, pamäť a agent zo seedu, simulácia bez výpisu */
+void replicate_run(uint64_t seed, ReplicateResult *r) {
+    sim->world_seed = seed;
+    explore_seed(seed);
+    init_world_physical(sim->dimension, world_dir);
+    if (!sim->linear_enabled) {
+        init_memory();
+    }
+    memset(&sim->agent, 0, sizeof(sim->agent));
+    memset(&sim->linear_q, 0, sizeof(sim->linear_q));
+    init_agent();
+    
+    sim->start_x = sim->dimension / 2;
+    sim->start_y = sim->dimension / 2;
+    sim->target_x = 0;
+    sim->target_y = 0;
+    sim->home_time = 0.0;
+    sim->bar_time = 0.0;
+    
+    double start = wall_time();
+    run_simulation();
+    r->time = wall_time() - start;
+    replicate_record(r, seed, sim->metrics.information_entropy, sim->metrics.thermal_entropy,
+                     sim->metrics.quantum_entropy);
+}
+
+/* Replikát Human je jeden agent, vlákna navyše nepotrebuje */
+void replicate_configure(int32_t threads, int32_t workers) {
+    (void)threads;
+    (void)workers;
+}
+
+/* Stav vlákna replikátov: nastavenia programu, vlastný svet, pamäť a agent */
+SimulationState *replicate_state_create() {
+    // linear_q je zarovnaná na 64 B, malloc by to nezaručil
+    SimulationState *state = (SimulationState*)aligned_alloc(__alignof__(SimulationState),
+                                                             sizeof(SimulationState));
+    if (!state) {
+        printf("Chyba: Nedostatok pamäte pre stav replikátu\n");
+        exit(1);
+    }
+    *state = *sim;
+    state->quiet = 1;
+    return state;
+}
+
+void replicate_state_destroy(SimulationState *state) {
+    arena_release(&state->world_arena);
+    free(state);
+}
+
+/* ==================== ROZHRANIE KNIŽNICE ==================== */
+
+/* Variant jadier: vynútený cez --kernel=, inak najširší, ktorý CPU podporuje.
+ * Varianty má iba redukcia teplôt; q_argmax pracuje so štyrmi floatmi, ktoré
+ * zaplnia jeden SSE register v každom variante. */
+void kernel_select() {
+    if (kernel_forced >= 0) {
+        kernel_variant = (KernelVariant)kernel_forced;
+    } else {
+        kernel_variant = KERNEL_SCALAR;
+        for (int v = KERNEL_SCALAR; v < KERNEL_VARIANTS; v++) {
+            if (kernel_supported((KernelVariant)v)) kernel_variant = (KernelVariant)v;
         }
     }
-    metrics.average_temperature = total_temp / (dimension * dimension);
     
-    float delta_S = metrics.thermal_entropy - metrics.information_entropy;
-    if (agent.total_energy_cost > 0) {
-        metrics.learning_efficiency = delta_S / agent.total_energy_cost;
+    thermal_worker = thermal_worker_variants[kernel_variant];
+}
+
+/* Simulácia rozhrania (kybernaut_human.h) nesie vlastný stav behu vrátane
+ * generátora explorácie a rozpracovaný beh; operácia naň na svoj čas
+ * nastaví sim volajúceho vlákna. Rôzne simulácie sa tak dajú volať aj
+ * súčasne z viacerých vlákien. Tabuľka chladenia a varianty jadier
+ * nezávisia od sveta a pripravia sa raz. */
+struct HumanSimulation {
+    SimulationState state;
+    SimulationRun run;
+};
+
+pthread_once_t human_library_once = PTHREAD_ONCE_INIT;
+
+void human_library_init() {
+    kernel_select();
+    init_cooling_table();
+}
+
+HumanSimulation *human_create(const HumanConfig *config) {
+    if (config->dimension < 5) return NULL;
+    // linear_q je zarovnaná na 64 B, calloc by to nezaručil
+    HumanSimulation *simulation = (HumanSimulation*)aligned_alloc(__alignof__(HumanSimulation),
+                                                                  sizeof(HumanSimulation));
+    if (!simulation) return NULL;
+    memset(simulation, 0, sizeof(HumanSimulation));
+    pthread_once(&human_library_once, human_library_init);
+    
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    sim->dimension = config->dimension;
+    sim->world_seed = config->seed;
+    sim->world_init_threads = config->threads > 0 ? config->threads : 1;
+    sim->linear_enabled = config->linear;
+    sim->quantum_incremental = !config->linear;
+    sim->quiet = 1;
+    explore_seed(config->seed);
+    
+    init_world_physical(sim->dimension, config->world_dir);
+    if (!sim->linear_enabled) {
+        init_memory();
     }
+    init_agent();
+    
+    sim->start_x = sim->dimension / 2;
+    sim->start_y = sim->dimension / 2;
+    sim->target_x = 0;
+    sim->target_y = 0;
+    simulation_begin(&simulation->run);
+    sim = saved_sim;
+    
+    return simulation;
+}
+
+int64_t human_step(HumanSimulation *simulation, int64_t steps) {
+    if (simulation->run.finished) return 0;
+    
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    int64_t first = sim->agent.steps;
+    int64_t done = 0;
+    while (done < steps && simulation_step(&simulation->run)) {
+        done++;
+    }
+    if (done < steps) {
+        simulation_finish(&simulation->run);
+    }
+    int64_t advanced = sim->agent.steps - first;
+    sim = saved_sim;
+    
+    return advanced;
+}
+
+void human_metrics(HumanSimulation *simulation, HumanMetrics *out) {
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    // Počas behu iba prepočet metrík, beh pokračuje ďalej
+    if (!simulation->run.finished) finalize_metrics();
+    
+    out->information_entropy = sim->metrics.information_entropy;
+    out->thermal_entropy = sim->metrics.thermal_entropy;
+    out->quantum_entropy = sim->metrics.quantum_entropy;
+    out->delta_s = sim->metrics.thermal_entropy - sim->metrics.information_entropy;
+    out->ratio = sim->metrics.information_entropy > 0 ?
+                 sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0;
+    out->coverage = sim->metrics.coverage;
+    out->visited_cells = sim->metrics.visited_cells;
+    out->energy = sim->metrics.total_energy_used;
+    out->average_temperature = sim->metrics.average_temperature;
+    out->exploration_rate = sim->agent.exploration_rate;
+    out->home_reached = sim->agent.home_reached;
+    out->bar_reached = sim->agent.bar_reached;
+    out->steps = sim->agent.steps;
+    out->finished = simulation->run.finished;
+    sim = saved_sim;
+}
+
+void human_destroy(HumanSimulation *simulation) {
+    if (!simulation) return;
+    arena_release(&simulation->state.world_arena);
+    free(simulation);
 }
 
 /* ==================== HLAVNÝ PROGRAM ==================== */
 
-int main() {
-    srand(time(NULL));
+#ifndef KYBERNAUT_LIBRARY
+
+/* --quiet: metriky behu v jednom riadku kľúč=hodnota (názvy ako stĺpce súhrnu) */
+void print_quiet_metrics(double total_time) {
+    printf("Human Dim=%"PRId32" Seed=%"PRIu64" S_info=%.6f S_thermal=%.6f S_quantum=%.6f "
+           "DeltaS=%.6f Ratio=%.6f Coverage=%.4f Time=%.3f\n",
+           sim->dimension, sim->world_seed, sim->metrics.information_entropy, sim->metrics.thermal_entropy,
+           sim->metrics.quantum_entropy, sim->metrics.thermal_entropy - sim->metrics.information_entropy,
+           sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0,
+           sim->metrics.coverage, total_time);
+}
+
+void print_usage(const char* program) {
+    printf("Použitie: %s [voľby]\n", program);
+    printf("  --dim N        rozmer sveta (inak sa zadá interaktívne)\n");
+    printf("  --seed S       seed sveta a explorácie (predvolené: čas štartu)\n");
+    printf("  --threads T    vlákna inicializácie sveta (predvolené: všetky jadrá)\n");
+    printf("  --init-only    iba inicializácia sveta (meranie štartu)\n");
+    printf("  --bench-entropy porovná skalárny výpočet tepelnej entropie so SIMD jadrom\n");
+    printf("  --kernel=V     variant jadier: scalar, avx2, avx512 (predvolené: podľa CPU)\n");
+    printf("  --no-hugepages aréna sveta bez veľkých stránok (MADV_HUGEPAGE)\n");
+    printf("  --lookahead    paralelný plánovač s rolloutmi hĺbky %d\n", MEMORY_DEPTH);
+    printf("  --plan-ms MS   rozpočet plánovača na rozhodnutie (predvolené 1 ms)\n");
+    printf("  --agents K     K agentov (Hogwild) nad zdieľanou pamäťou Q\n");
+    printf("  --sweeping     prioritizované zametanie vo vlákne na pozadí\n");
+    printf("  --cost-to-go   Q-hodnoty predvyplnené z ceny k cieľom (Dijkstra)\n");
+    printf("  --linear       lineárna Q s pevnou pamäťou namiesto tabuľky buniek\n");
+    printf("  --save-q F     na konci uloží riedky snapshot pamäte Q do súboru F\n");
+    printf("  --load-q F     teplý štart z snapshotu F (rovnaký rozmer a seed)\n");
+    printf("  --replicates N N behov so seedmi S..S+N-1 v --threads vláknach, štatistika do CSV\n");
+    printf("  --summary F    súhrn replikátov (predvolené: summary.csv)\n");
+    printf("  --world-dir D  svet zo súboru v D zdieľaného s Kybernaut-Light (vytvorí ho prvý)\n");
+    printf("  --quiet        bez baneru, priebehu a logu; jeden riadok metrík (vyžaduje --dim)\n");
+    printf("  --help         zobrazí túto nápovedu\n");
+}
+
+/* Spracovanie argumentov príkazového riadku; vráti 0 pri chybe */
+int parse_arguments(int argc, char* argv[], int32_t* dim) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (strcmp(arg, "--dim") == 0 && value) {
+            *dim = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            sim->world_seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            sim->world_init_threads = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--init-only") == 0) {
+            init_only = 1;
+        } else if (strcmp(arg, "--bench-entropy") == 0) {
+            bench_entropy = 1;
+        } else if (strncmp(arg, "--kernel=", 9) == 0) {
+            kernel_forced = kernel_lookup(arg + 9);
+            if (kernel_forced < 0) {
+                printf("Chyba: Neznámy variant jadier '%s' (scalar, avx2, avx512)\n", arg + 9);
+                return 0;
+            }
+        } else if (strcmp(arg, "--no-hugepages") == 0) {
+            huge_pages_enabled = 0;
+        } else if (strcmp(arg, "--lookahead") == 0) {
+            lookahead_enabled = 1;
+        } else if (strcmp(arg, "--plan-ms") == 0 && value) {
+            lookahead_budget = strtod(value, NULL) / 1000.0;
+            i++;
+        } else if (strcmp(arg, "--save-q") == 0 && value) {
+            q_save_path = value;
+            i++;
+        } else if (strcmp(arg, "--load-q") == 0 && value) {
+            q_load_path = value;
+            i++;
+        } else if (strcmp(arg, "--linear") == 0) {
+            sim->linear_enabled = 1;
+        } else if (strcmp(arg, "--cost-to-go") == 0) {
+            cost_to_go_enabled = 1;
+        } else if (strcmp(arg, "--sweeping") == 0) {
+            sweeping_enabled = 1;
+        } else if (strcmp(arg, "--agents") == 0 && value) {
+            hogwild_agents = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--replicates") == 0 && value) {
+            replicate_count = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--summary") == 0 && value) {
+            replicate_summary = value;
+            i++;
+        } else if (strcmp(arg, "--world-dir") == 0 && value) {
+            world_dir = value;
+            i++;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            sim->quiet = 1;
+        } else {
+            printf("Chyba: Neznáma voľba '%s'\n", arg);
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    
+    // Tichý beh je pre skripty, nesmie čakať na rozmer ani potvrdenie
+    if (sim->quiet && *dim <= 0) {
+        printf("Chyba: --quiet potrebuje --dim.\n");
+        return 0;
+    }
+    
+    if (sim->world_init_threads < 0) {
+        printf("Chyba: Neplatný počet vlákien.\n");
+        return 0;
+    }
+    
+    if (kernel_forced >= 0 && !kernel_supported((KernelVariant)kernel_forced)) {
+        printf("Chyba: CPU nepodporuje variant jadier %s.\n", kernel_names[kernel_forced]);
+        return 0;
+    }
+    
+    if (lookahead_budget <= 0.0) {
+        printf("Chyba: Rozpočet plánovača musí byť kladný.\n");
+        return 0;
+    }
+    
+    if (hogwild_agents < 1) {
+        printf("Chyba: Neplatný počet agentov.\n");
+        return 0;
+    }
+    
+    // Plánovače a Hogwild pracujú s tabuľkou pamäte buniek
+    if (sim->linear_enabled && (lookahead_enabled || sweeping_enabled || cost_to_go_enabled || hogwild_agents > 1 ||
+                           q_save_path || q_load_path)) {
+        printf("Chyba: --linear nemožno kombinovať s --lookahead, --sweeping, --cost-to-go, --agents ani snapshotom Q.\n");
+        return 0;
+    }
+    
+    // Plánovače držia globálneho agenta, Hogwild agenti sú samostatní.
+    // Predvyplnenie sa po dosiahnutí cieľa posúva k novému cieľu, každý
+    // Hogwild agent však mení ciele sám nad jednou zdieľanou tabuľkou Q
+    if (hogwild_agents > 1 && (lookahead_enabled || sweeping_enabled || cost_to_go_enabled)) {
+        printf("Chyba: --lookahead, --sweeping a --cost-to-go podporujú iba jedného agenta.\n");
+        return 0;
+    }
+    
+    // Rozptyl potrebuje aspoň dva behy; replikát je jeden agent bez plánovačov
+    // a snapshotov, ktoré by zdieľal s ďalšími behmi
+    if (replicate_count < 0 || replicate_count == 1) {
+        printf("Chyba: --replicates potrebuje aspoň 2 behy.\n");
+        return 0;
+    }
+    if (replicate_count > 0 && (lookahead_enabled || sweeping_enabled || cost_to_go_enabled ||
+                                hogwild_agents > 1 || q_save_path || q_load_path ||
+                                init_only || bench_entropy)) {
+        printf("Chyba: --replicates nemožno kombinovať s --lookahead, --sweeping, --cost-to-go, --agents, snapshotom Q, --init-only ani --bench-entropy.\n");
+        return 0;
+    }
+    
+    // Koherenciu priebežne sleduje iba jediný zapisovateľ tabuľky Q
+    sim->quantum_incremental = !sim->linear_enabled && !sweeping_enabled && hogwild_agents <= 1;
+    
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    static SimulationState state;
+    sim = &state;
     
-    printf("╔══════════════════════════════════════════════════════════════╗\n");
-    printf("║          KYBERNAUT-HUMAN v3.1 - FYZIKÁLNA VERZIA           ║\n");
-    printf("║           (Opravená matematika a 3D→2D projekcia)          ║\n");
-    printf("║                PODPORA PRE VEĽKÉ MRIEŽKY                  ║\n");
-    printf("╚══════════════════════════════════════════════════════════════╝\n\n");
+    // Bez --seed sa svet aj explorácia odvodia od času štartu
+    sim->world_seed = (uint64_t)time(NULL);
     
-    printf("FYZIKÁLNA KOREKTNOSŤ:\n");
-    printf("  • Všetky entropie normalizované na rozsah 0-1\n");
-    printf("  • Projekcia 3D fyziky do 2D simulácie\n");
-    printf("  • Reálne fyzikálne konštanty a jednotky\n");
-    printf("  • Kontrola matematických limitov\n\n");
+    int32_t cli_dimension = 0;
+    if (!parse_arguments(argc, argv, &cli_dimension)) {
+        return 1;
+    }
+    kernel_select();
+    init_cooling_table();
+    if (sim->world_init_threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        sim->world_init_threads = cores > 0 ? (int32_t)cores : 1;
+    }
+    explore_seed(sim->world_seed);
+    
+    if (!sim->quiet) {
+        printf("╔══════════════════════════════════════════════════════════════╗\n");
+        printf("║          KYBERNAUT-HUMAN v3.1 - FYZIKÁLNA VERZIA           ║\n");
+        printf("║           (Opravená matematika a 3D→2D projekcia)          ║\n");
+        printf("║                PODPORA PRE VEĽKÉ MRIEŽKY                  ║\n");
+        printf("╚══════════════════════════════════════════════════════════════╝\n\n");
+        
+        printf("FYZIKÁLNA KOREKTNOSŤ:\n");
+        printf("  • Všetky entropie normalizované na rozsah 0-1\n");
+        printf("  • Projekcia 3D fyziky do 2D simulácie\n");
+        printf("  • Reálne fyzikálne konštanty a jednotky\n");
+        printf("  • Kontrola matematických limitov\n\n");
+    }
     
-    printf("Zadaj rozmer sveta (napr. 15-1000): ");
-    if (scanf("%"SCNd32, &dimension) != 1 || dimension < 5) {
-        printf("Chyba: Neplatný rozmer.\n");
+    if (cli_dimension > 0) {
+        sim->dimension = cli_dimension;
+        if (sim->dimension < 5) {
+            printf("Chyba: Neplatný rozmer.\n");
+            return 1;
+        }
+    } else {
+        printf("Zadaj rozmer sveta (napr. 15-1000): ");
+        if (scanf("%"SCNd32, &sim->dimension) != 1 || sim->dimension < 5) {
+            printf("Chyba: Neplatný rozmer.\n");
+            return 1;
+        }
+    }
+    
+    if ((q_save_path || q_load_path) && (uint64_t)sim->dimension * sim->dimension > Q_SNAPSHOT_MAX_CELLS) {
+        printf("Chyba: Snapshot pamäte Q podporuje najviac %"PRIu64" buniek (svet do 65536x65536).\n",
+               Q_SNAPSHOT_MAX_CELLS);
         return 1;
     }
     
-    if (dimension > 1000) {
-        float memory_required = dimension * dimension * 
-                               (sizeof(Node) + sizeof(MemoryNode)) / (1024.0 * 1024.0);
+    // Rozmer z príkazového riadku sa považuje za potvrdený
+    if (sim->dimension > 1000 && cli_dimension == 0) {
+        size_t cell_bytes = sim->linear_enabled ? sizeof(Cell) + sizeof(Node)
+                                           : sizeof(FusedCell) + sizeof(Node) + sizeof(MemoryNode);
+        float memory_required = (double)sim->dimension * sim->dimension * 
+                               cell_bytes / (1024.0 * 1024.0);
         printf("POZOR: Veľký rozmer %"PRId32"x%"PRId32" vyžaduje približne %.2f MB pamäte\n",
-               dimension, dimension, memory_required);
+               sim->dimension, sim->dimension, memory_required);
         printf("Naozaj pokračovať? (a/n): ");
         char confirm;
         scanf(" %c", &confirm);
         if (confirm != 'a' && confirm != 'A') return 0;
     }
     
-    init_world_physical(dimension);
-    init_memory();
+    // Jadrá delia replikáty, každý svet inicializuje jedno vlákno
+    if (replicate_count > 0) {
+        int32_t workers = sim->world_init_threads;
+        sim->world_init_threads = 1;
+        return run_replicates(sim->world_seed, workers, sim->dimension);
+    }
+    
+    double world_start = wall_time();
+    init_world_physical(sim->dimension, world_dir);
+    if (!sim->quiet) {
+        printf("Svet pripravený za %.3f s (seed %"PRIu64")\n", wall_time() - world_start, sim->world_seed);
+        printf("  • Aréna: %.1f MB, mmap %.3f ms, veľké stránky: %s, rezidentná pamäť %.1f MB\n",
+               sim->world_arena.capacity / 1048576.0, sim->world_arena.alloc_time * 1000.0,
+               sim->world_arena.huge_pages ? "áno" : "nie", resident_memory() / 1048576.0);
+    }
+    
+    if (init_only) {
+        arena_release(&sim->world_arena);
+        return 0;
+    }
+    
+    if (!sim->linear_enabled) {
+        init_memory();
+    }
     init_agent();
     
-    start_x = dimension / 2;
-    start_y = dimension / 2;
-    target_x = 0;
-    target_y = 0;
+    if (bench_entropy) {
+        run_entropy_benchmark();
+        arena_release(&sim->world_arena);
+        return 0;
+    }
     
-    printf("\nŠtart: [%"PRId32",%"PRId32"], Ciele: Domov[0,0] -> Bar[%"PRId32",%"PRId32"]\n",
-           start_x, start_y, dimension-1, dimension-1);
-    printf("Fyzikálna interpretácia:\n");
-    printf("  • 1 bunka = %.1e m\n", CELL_SIZE);
-    printf("  • 1 krok = %.1e s\n", TIME_STEP);
-    printf("  • Energetická jednotka = %.1e J\n", ENERGY_UNIT);
-    printf("  • Maximálny počet krokov: %d\n\n", MAX_STEPS);
+    sim->start_x = sim->dimension / 2;
+    sim->start_y = sim->dimension / 2;
+    sim->target_x = 0;
+    sim->target_y = 0;
+    
+    if (!sim->quiet) {
+        printf("\nŠtart: [%"PRId32",%"PRId32"], Ciele: Domov[0,0] -> Bar[%"PRId32",%"PRId32"]\n",
+               sim->start_x, sim->start_y, sim->dimension-1, sim->dimension-1);
+        printf("Fyzikálna interpretácia:\n");
+        printf("  • 1 bunka = %.1e m\n", CELL_SIZE);
+        printf("  • 1 krok = %.1e s\n", TIME_STEP);
+        printf("  • Energetická jednotka = %.1e J\n", ENERGY_UNIT);
+        printf("  • Maximálny počet krokov: %d\n\n", MAX_STEPS);
+    }
     
-    clock_t start_time = clock();
-    run_simulation();
-    clock_t end_time = clock();
-    double total_time = (double)(end_time - start_time) / CLOCKS_PER_SEC;
+    if (q_load_path) {
+        q_snapshot_load(q_load_path);
+    }
+    if (cost_to_go_enabled) {
+        init_cost_to_go();
+    }
+    
+    // Nástenný čas - pri viacerých agentoch by clock() sčítal CPU čas vlákien
+    double start_time = wall_time();
+    if (hogwild_agents > 1) {
+        run_hogwild();
+    } else {
+        run_simulation();
+    }
+    double total_time = wall_time() - start_time;
+    
+    if (sim->quiet) {
+        print_quiet_metrics(total_time);
+        if (q_save_path && q_snapshot_save(q_save_path) < 0) {
+            printf("Chyba: Snapshot pamäte Q sa nepodarilo uložiť do '%s'\n", q_save_path);
+        }
+        free(learners);
+        for (int t = 0; t < COST_TO_GO_TARGETS; t++) {
+            free(cost_to_go[t]);
+        }
+        arena_release(&sim->world_arena);
+        return 0;
+    }
     
     printf("\n══════════════════════════════════════════════════════════════\n");
     printf("              VÝSLEDKY KYBERNAUT-HUMAN v3.1\n");
     printf("══════════════════════════════════════════════════════════════\n\n");
     
     printf("FYZIKÁLNE METRIKY:\n");
-    printf("  Kroky simulácie: %"PRId32"\n", agent.steps);
-    printf("  Celková energia: %.3e J\n", metrics.total_energy_used);
-    printf("  Priemerná teplota: %.1f K\n", metrics.average_temperature);
+    printf("  Kroky simulácie: %"PRId32"\n", sim->agent.steps);
+    printf("  Celková energia: %.3e J\n", sim->metrics.total_energy_used);
+    printf("  Priemerná teplota: %.1f K\n", sim->metrics.average_temperature);
     printf("  Čas simulácie: %.3f s\n", total_time);
+    printf("  Rezidentná pamäť: %.1f MB (aréna %.1f MB, mmap %.3f ms)\n",
+           resident_memory() / 1048576.0, sim->world_arena.capacity / 1048576.0,
+           sim->world_arena.alloc_time * 1000.0);
+    printf("  Jadrá: %s (%s)\n", kernel_names[kernel_variant],
+           kernel_forced >= 0 ? "--kernel" : "podľa CPU");
     
     printf("\nENTROPICKÁ ANALÝZA (normalizované 0-1):\n");
-    printf("  Informačná entropia (S_info): %.4f\n", metrics.information_entropy);
-    printf("  Tepelná entropia (S_thermal): %.4f\n", metrics.thermal_entropy);
-    printf("  Kvantová entropia (S_quantum): %.4f\n", metrics.quantum_entropy);
+    printf("  Informačná entropia (S_info): %.4f\n", sim->metrics.information_entropy);
+    printf("  Tepelná entropia (S_thermal): %.4f\n", sim->metrics.thermal_entropy);
+    printf("  Kvantová entropia (S_quantum): %.4f\n", sim->metrics.quantum_entropy);
     printf("  Rozdiel S_thermal - S_info: %.4f\n", 
-           metrics.thermal_entropy - metrics.information_entropy);
+           sim->metrics.thermal_entropy - sim->metrics.information_entropy);
     printf("  Pomer S_thermal/S_info: %.3f\n",
-           metrics.information_entropy > 0 ? metrics.thermal_entropy / metrics.information_entropy : 0);
+           sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0);
     
     printf("\nINFORMAČNÉ METRIKY:\n");
     printf("  Pokrytie sveta: %"PRId64"/%"PRId64" buniek (%.1f%%)\n",
-           metrics.visited_cells, metrics.total_cells, metrics.coverage);
-    printf("  Efektivita informácie: %.3e bit/J\n", metrics.information_efficiency);
-    printf("  Rozhodnutí: %"PRId64"\n", agent.decisions_made);
+           sim->metrics.visited_cells, sim->metrics.total_cells, sim->metrics.coverage);
+    printf("  Efektivita informácie: %.3e bit/J\n", sim->metrics.information_efficiency);
+    printf("  Rozhodnutí: %"PRId64"\n", sim->agent.decisions_made);
     
     printf("\nMETRIKY UČENIA:\n");
-    printf("  Entropia učenia: %.3e J/K\n", agent.learning_entropy);
-    printf("  Účinnosť učenia: %.3e ΔS/J\n", metrics.learning_efficiency);
-    printf("  Konečná miera explorácie: %.2f\n", agent.exploration_rate);
+    printf("  Entropia učenia: %.3e J/K\n", sim->agent.learning_entropy);
+    printf("  Účinnosť učenia: %.3e ΔS/J\n", sim->metrics.learning_efficiency);
+    printf("  Konečná miera explorácie: %.2f\n", sim->agent.exploration_rate);
+    if (sim->linear_enabled) {
+        printf("  Pamäť Q: lineárna, %zu B váh (%d príznakov, SIMD šírka %d)\n",
+               sizeof(LinearQ), LINEAR_FEATURES, LINEAR_WIDTH);
+    } else {
+        printf("  Pamäť Q: tabuľka, %.1f MB\n",
+               (double)sim->dimension * sim->dimension * (sizeof(MemoryNode) + sizeof(sim->q_table->q_values)) / 1048576.0);
+    }
+    printf("  Priepustnosť: %.0f krokov/s\n", total_time > 0 ? sim->agent.steps / total_time : 0.0);
+    if (lookahead_enabled) {
+        printf("  Paralelné vyhodnotenia: %"PRId64" rolloutov v %"PRId64" rozhodnutiach\n",
+               sim->agent.parallel_evals, lookahead_decisions);
+        printf("  Latencia plánovača: priemer %.1f µs, max %.1f µs\n",
+               lookahead_decisions > 0 ? lookahead_time_total / lookahead_decisions * 1e6 : 0.0,
+               lookahead_time_max * 1e6);
+    }
+    if (sweeping_enabled) {
+        printf("  Zametanie: %"PRId64" záloh (%.0f záloh/s), zlúčených %"PRId64", zahodených %"PRId64", uspaní %"PRId64"\n",
+               sweep_updates, sweep_time > 0 ? sweep_updates / sweep_time : 0.0, sweep_merged,
+               sweep_dropped, sweep_sleeps);
+        printf("  Kroky k cieľom: domov %"PRId32", bar %"PRId32"\n",
+               sim->agent.home_reached, sim->agent.bar_reached);
+    }
+    if (cost_to_go_enabled) {
+        printf("  Predvýpočet ceny k cieľom: %.3f s\n", cost_to_go_time);
+    }
+    if (q_warm_started) {
+        printf("\nTEPLÝ ŠTART (%"PRIu64" buniek, načítanie %.3f ms):\n", q_loaded.entries, q_load_time * 1000.0);
+        print_goal_reduction("Domov", q_loaded.home_reached, q_loaded.home_time, sim->agent.home_reached, sim->home_time);
+        print_goal_reduction("Bar", q_loaded.bar_reached, q_loaded.bar_time, sim->agent.bar_reached, sim->bar_time);
+    }
+    if (hogwild_agents > 1) {
+        printf("\nHOGWILD UČENIE (%"PRId32" agentov, %"PRId32" vlákien):\n", hogwild_agents, hogwild_agents);
+        if (hogwild_winner >= 0) {
+            printf("  Konvergencia: agent %"PRId32" za %.3f s (%"PRId32" krokov, domov %.3f s)\n",
+                   hogwild_winner, hogwild_time, learners[hogwild_winner].steps,
+                   learners[hogwild_winner].home_time);
+        } else {
+            printf("  Konvergencia: žiadny agent nedosiahol oba ciele za %.3f s\n", hogwild_time);
+        }
+        printf("  Kroky všetkých agentov: %"PRId32" (%.0f krokov/s)\n",
+               sim->agent.steps, sim->agent.steps / hogwild_time);
+    }
     
-    if (agent.home_reached) printf("  Domov dosiahnutý v kroku: %"PRId32"\n", agent.home_reached);
-    if (agent.bar_reached) printf("  Bar dosiahnutý v kroku: %"PRId32"\n", agent.bar_reached);
+    if (sim->agent.home_reached) printf("  Domov dosiahnutý v kroku: %"PRId32"\n", sim->agent.home_reached);
+    if (sim->agent.bar_reached) printf("  Bar dosiahnutý v kroku: %"PRId32"\n", sim->agent.bar_reached);
     
     printf("\n══════════════════════════════════════════════════════════════\n");
     printf("              MATEMATICKÁ VALIDÁCIA\n");
@@ -770,30 +2988,30 @@ int main() {
     
     int validation_passed = 1;
     
-    if (metrics.information_entropy < 0 || metrics.information_entropy > 1) {
-        printf("✗ S_info mimo rozsahu 0-1: %.4f\n", metrics.information_entropy);
+    if (sim->metrics.information_entropy < 0 || sim->metrics.information_entropy > 1) {
+        printf("✗ S_info mimo rozsahu 0-1: %.4f\n", sim->metrics.information_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_info v rozsahu 0-1: %.4f\n", metrics.information_entropy);
+        printf("✓ S_info v rozsahu 0-1: %.4f\n", sim->metrics.information_entropy);
     }
     
-    if (metrics.thermal_entropy < 0 || metrics.thermal_entropy > 1) {
-        printf("✗ S_thermal mimo rozsahu 0-1: %.4f\n", metrics.thermal_entropy);
+    if (sim->metrics.thermal_entropy < 0 || sim->metrics.thermal_entropy > 1) {
+        printf("✗ S_thermal mimo rozsahu 0-1: %.4f\n", sim->metrics.thermal_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_thermal v rozsahu 0-1: %.4f\n", metrics.thermal_entropy);
+        printf("✓ S_thermal v rozsahu 0-1: %.4f\n", sim->metrics.thermal_entropy);
     }
     
-    if (metrics.quantum_entropy < 0 || metrics.quantum_entropy > 1) {
-        printf("✗ S_quantum mimo rozsahu 0-1: %.4f\n", metrics.quantum_entropy);
+    if (sim->metrics.quantum_entropy < 0 || sim->metrics.quantum_entropy > 1) {
+        printf("✗ S_quantum mimo rozsahu 0-1: %.4f\n", sim->metrics.quantum_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_quantum v rozsahu 0-1: %.4f\n", metrics.quantum_entropy);
+        printf("✓ S_quantum v rozsahu 0-1: %.4f\n", sim->metrics.quantum_entropy);
     }
     
-    if (metrics.information_entropy > metrics.thermal_entropy) {
+    if (sim->metrics.information_entropy > sim->metrics.thermal_entropy) {
         printf(" S_info > S_thermal: %.4f > %.4f\n", 
-               metrics.information_entropy, metrics.thermal_entropy);
+               sim->metrics.information_entropy, sim->metrics.thermal_entropy);
         printf("   (Možno validné pre systémy s vysokou informačnou štruktúrou)\n");
     }
     
@@ -808,37 +3026,69 @@ int main() {
         fprintf(f, "KYBERNAUT-HUMAN v3.1 - Fyzikálne korektná verzia\n");
         fprintf(f, "================================================\n\n");
         fprintf(f, "Fyzikálne parametre:\n");
-        fprintf(f, "  Rozmer sveta: %"PRId32" x %"PRId32" buniek\n", dimension, dimension);
+        fprintf(f, "  Rozmer sveta: %"PRId32" x %"PRId32" buniek\n", sim->dimension, sim->dimension);
         fprintf(f, "  Veľkosť bunky: %.1e m\n", CELL_SIZE);
         fprintf(f, "  Časový krok: %.1e s\n", TIME_STEP);
-        fprintf(f, "  Simulačný čas: %.3f s\n\n", total_time);
+        fprintf(f, "  Simulačný čas: %.3f s\n", total_time);
+        fprintf(f, "  Rezidentná pamäť: %.1f MB (aréna %.1f MB, mmap %.3f ms, veľké stránky: %s)\n",
+                resident_memory() / 1048576.0, sim->world_arena.capacity / 1048576.0,
+                sim->world_arena.alloc_time * 1000.0, sim->world_arena.huge_pages ? "áno" : "nie");
+        fprintf(f, "  Jadrá: %s\n\n", kernel_names[kernel_variant]);
         
         fprintf(f, "Entropické metriky (0-1):\n");
-        fprintf(f, "  S_info: %.4f\n", metrics.information_entropy);
-        fprintf(f, "  S_thermal: %.4f\n", metrics.thermal_entropy);
-        fprintf(f, "  S_quantum: %.4f\n", metrics.quantum_entropy);
-        fprintf(f, "  ΔS: %.4f\n", metrics.thermal_entropy - metrics.information_entropy);
+        fprintf(f, "  S_info: %.4f\n", sim->metrics.information_entropy);
+        fprintf(f, "  S_thermal: %.4f\n", sim->metrics.thermal_entropy);
+        fprintf(f, "  S_quantum: %.4f\n", sim->metrics.quantum_entropy);
+        fprintf(f, "  ΔS: %.4f\n", sim->metrics.thermal_entropy - sim->metrics.information_entropy);
         fprintf(f, "  Pomer: %.3f\n\n", 
-                metrics.information_entropy > 0 ? metrics.thermal_entropy / metrics.information_entropy : 0);
+                sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0);
         
         fprintf(f, "Fyzikálne metriky:\n");
-        fprintf(f, "  Celková energia: %.3e J\n", metrics.total_energy_used);
-        fprintf(f, "  Priemerná teplota: %.1f K\n", metrics.average_temperature);
-        fprintf(f, "  Pokrytie: %.1f%%\n", metrics.coverage);
+        fprintf(f, "  Celková energia: %.3e J\n", sim->metrics.total_energy_used);
+        fprintf(f, "  Priemerná teplota: %.1f K\n", sim->metrics.average_temperature);
+        fprintf(f, "  Pokrytie: %.1f%%\n", sim->metrics.coverage);
+        if (lookahead_enabled) {
+            fprintf(f, "  Paralelné vyhodnotenia: %"PRId64" (%"PRId64" rozhodnutí, max %.1f µs)\n",
+                    sim->agent.parallel_evals, lookahead_decisions, lookahead_time_max * 1e6);
+        }
+        if (cost_to_go_enabled) {
+            fprintf(f, "  Cena k cieľom: %.3f s, domov v kroku %"PRId32", bar v kroku %"PRId32"\n",
+                    cost_to_go_time, sim->agent.home_reached, sim->agent.bar_reached);
+        }
+        if (sweeping_enabled) {
+            fprintf(f, "  Zametanie: %"PRId64" záloh, %.0f záloh/s\n",
+                    sweep_updates, sweep_time > 0 ? sweep_updates / sweep_time : 0.0);
+        }
+        if (hogwild_agents > 1) {
+            fprintf(f, "  Hogwild: %"PRId32" agentov, konvergencia %s za %.3f s, %.0f krokov/s\n",
+                    hogwild_agents, hogwild_winner >= 0 ? "áno" : "nie", hogwild_time,
+                    sim->agent.steps / hogwild_time);
+        }
+        if (q_warm_started) {
+            fprintf(f, "  Teplý štart: %"PRIu64" buniek, domov %"PRId32" → %"PRId32", bar %"PRId32" → %"PRId32" krokov\n",
+                    q_loaded.entries, q_loaded.home_reached, sim->agent.home_reached,
+                    q_loaded.bar_reached, sim->agent.bar_reached);
+        }
         
         fclose(f);
         printf("\nVýsledky uložené do: %s\n", LOG_FILENAME);
     }
     
-    for (int32_t i = 0; i < dimension; i++) {
-        free(world[i]);
-        for (int32_t j = 0; j < dimension; j++) {
-            pthread_mutex_destroy(&memory[i][j].mutex);
+    if (q_save_path) {
+        int64_t saved = q_snapshot_save(q_save_path);
+        if (saved < 0) {
+            printf("Chyba: Snapshot pamäte Q sa nepodarilo uložiť do '%s'\n", q_save_path);
+        } else {
+            printf("Snapshot pamäte Q: %s (%"PRId64" buniek, %.1f kB)\n", q_save_path, saved,
+                   (sizeof(QSnapshotHeader) + saved * sizeof(QSnapshotEntry)) / 1024.0);
         }
-        free(memory[i]);
     }
-    free(world);
-    free(memory);
+    
+    free(learners);
+    for (int t = 0; t < COST_TO_GO_TARGETS; t++) {
+        free(cost_to_go[t]);
+    }
+    arena_release(&sim->world_arena);
     
     pthread_mutex_destroy(&print_mutex);
     pthread_mutex_destroy(&global_mutex);
@@ -849,3 +3099,4 @@ int main() {
     
     return 0;
 }
+#endif
@@ -0,0 +1,67 @@
+/**
+ * KYBERNAUT-HUMAN v3.1 - rozhranie knižnice
+ * Autor: Peter Leukanič
+ * Rok: 2026
+ *
+ * Agent s Q-učením bez konzoly: svet z konfigurácie a seedu, N krokov
+ * agenta, metriky, zrušenie. Simulácií môže byť naraz ľubovoľne veľa
+ * a kroky sa môžu striedať. Rôzne simulácie sa dajú volať súčasne
+ * z viacerých vlákien, jedna simulácia však naraz iba z jedného. Každá
+ * simulácia má vlastný generátor explorácie, rand() volajúceho nepoužíva.
+ * Výsledok po dobehnutí je rovnaký ako
+ * `kybernaut_human --dim N --seed S --threads T --quiet` (s --linear pri
+ * linear = 1).
+ *
+ * Preklad: make lib-human (libkybernaut_human.so). Knižnica exportuje iba
+ * funkcie human_*, dá sa teda načítať spolu s libkybernaut_light.so.
+ */
+
+#ifndef KYBERNAUT_HUMAN_H
+#define KYBERNAUT_HUMAN_H
+
+#include <stdint.h>
+
+#ifndef KYBERNAUT_API
+#define KYBERNAUT_API __attribute__((visibility("default")))
+#endif
+
+typedef struct {
+    int32_t dimension;            // Rozmer sveta (aspoň 5)
+    uint64_t seed;                // Seed sveta a explorácie
+    int linear;                   // 1 = lineárna Q namiesto tabuľky buniek
+    int32_t threads;              // Vlákna inicializácie a tepelnej entropie (0 = 1)
+    const char *world_dir;        // Zdieľaný súbor sveta (--world-dir), NULL = z hashu
+} HumanConfig;
+
+typedef struct {
+    double information_entropy;   // S_info (0-1)
+    double thermal_entropy;       // S_thermal (0-1)
+    double quantum_entropy;       // S_quantum (0-1)
+    double delta_s;               // S_thermal − S_info
+    double ratio;                 // S_thermal / S_info (0, ak S_info = 0)
+    double coverage;              // Pokrytie [%]
+    int64_t visited_cells;
+    double energy;                // Celková energia [J]
+    double average_temperature;   // [K]
+    double exploration_rate;      // Aktuálne ε
+    int32_t home_reached;         // Krok dosiahnutia domova (0 = zatiaľ nie)
+    int32_t bar_reached;          // Krok dosiahnutia baru (0 = zatiaľ nie)
+    int64_t steps;                // Vykonané kroky agenta
+    int finished;                 // 1 = misia alebo MAX_STEPS, metriky sú záverečné
+} HumanMetrics;
+
+typedef struct HumanSimulation HumanSimulation;
+
+/* Svet, pamäť Q, agent a metriky; NULL pri neplatnej konfigurácii. Chyby
+ * sveta (pamäť, súbor world_dir) ukončia proces s hlásením ako v CLI. */
+KYBERNAUT_API HumanSimulation *human_create(const HumanConfig *config);
+
+/* Najviac steps krokov agenta; vráti počet vykonaných, 0 = beh skončil */
+KYBERNAUT_API int64_t human_step(HumanSimulation *sim, int64_t steps);
+
+/* Metriky aktuálneho stavu (počas behu priebežné, po skončení záverečné) */
+KYBERNAUT_API void human_metrics(HumanSimulation *sim, HumanMetrics *out);
+
+KYBERNAUT_API void human_destroy(HumanSimulation *sim);
+
+#endif
@@ -12,6 +12,23 @@
  * OPRAVENÉ CHYBY:
  * - Pridané is_target do OpticalNode
  * - Odstránený nepoužitý parameter B
+ *
+ * VÝKONNOSTNÉ ÚPRAVY:
+ * - Inkrementálne entropické akumulátory (snímka entropie v O(1))
+ * - Ensemble režim: N fotónov paralelne na všetkých jadrách, riedke privátne dlaždice vlákien
+ * - Prechodové tabuľky váh pre dvojice materiálov a diskrétne smery
+ * - Svet ako štruktúra polí v jednej alokácii (horúce/studené polia)
+ * - Detekcia cyklov dráhy (Brent) a rýchly posun uväzneného fotónu
+ * - Preskakovanie homogénnych oblastí podľa vzdialenosti k rozhraniu
+ * - Procedurálny riedky svet (materiál z hashu, uložené iba dotknuté bunky)
+ * - Počítadlový generátor (seed, bunka) a paralelná inicializácia sveta
+ * - Aréna sveta v mmap s veľkými stránkami a paralelným prvým dotykom
+ * - Paralelné SIMD jadro tepelnej entropie v jednom prechode poľom
+ * - Prenosná binárka: varianty jadier scalar/AVX2/AVX-512 vybrané pri štarte
+ * - Replikáty v súbežných vláknach s Welfordovou štatistikou a t-testom
+ * - Zdieľaný svet s Kybernaut-Human (mmap súboru, --world-dir) a párový t-test
+ * - Tichý režim (--quiet) a knižnica s rozhraním create/step/metrics/destroy (kybernaut_light.h)
+ * - Stav behu v štruktúre (SimulationState), simulácie knižnice súbežne vo vláknach
  */
 
 #include <stdio.h>
@@ -19,10 +36,27 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <errno.h>
 #include <inttypes.h>  // PRIDANÉ: Pre veľké mriežky
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "kybernaut_light.h"
+
+// Súhrn replikátov: riadky Light a porovnanie Light − Human
+#define REPLICATE_MODEL "Light"
+#define REPLICATE_PEER "Human"
+#define REPLICATE_TITLE "LIGHT"
+#define REPLICATE_WELCH(own, peer, t, df, p) welch_test(own, peer, t, df, p)
+#define REPLICATE_PAIR(own, peer) ((own) - (peer))
+#include "kybernaut_common.h"
 
 #define MAX_STEPS 20000           // ZVÝŠENÉ pre veľké mriežky
 #define LOG_FILENAME "kybernaut_light_v3.1_log.txt"
+#define ENSEMBLE_CHUNK 16         // Fotóny pridelené vláknu naraz
 
 /* ==================== FYZIKÁLNE KONŠTANTY A PROJEKCIA ==================== */
 
@@ -60,22 +94,46 @@ OpticalMaterial materials[5] = {
     {10.000,  1.0e4,   1.0e-1,  1.0e4,   10.000,  1.0e3,   "prekážka", 'X'}
 };
 
+/* Stav bunky procedurálneho sveta, ktorú fotón navštívil. Nedotknuté
+ * bunky sa neukladajú - ich materiál aj teplota vyplývajú z hashu. */
+typedef struct {
+    int64_t cell;                 // Index bunky (-1 = voľný slot)
+    int32_t photon_visits;
+    float temperature;
+    float energy_density;
+    float accumulated_phase;
+    float interference_pattern;
+} SparseCell;
+
+/* Optický svet ako štruktúra polí v jednej súvislej aréne.
+ * Bunka [x][y] má index y·dimension + x, takže inicializácia aj prechody
+ * mriežkou idú po pamäti sekvenčne. Polia čítané v každom kroku fotónu
+ * sú oddelené od studených. Súradnice, optická hĺbka (daná materiálom)
+ * a cieľové bunky sa neukladajú po bunkách. */
 typedef struct {
-    int32_t x, y;               // PRIDANÉ: int32_t pre veľké mriežky
-    int32_t photon_visits;      // PRIDANÉ: int32_t pre veľké počty
-    float energy_density;       // Hustota energie [J/m³]
-    float temperature;          // Teplota [K] (z absorpcie)
-    float optical_depth;        // Optická hĺbka (bezrozmerná)
-    int material_id;            // ID optického materiálu
-    int is_target;              // OPRAVA: Pridané pre ciele (0=žiadny, 1=domov, 2=bar)
-    
-    // Interferenčné efekty
-    float accumulated_phase;    // Kumulatívna fáza pre interferenciu
-    float interference_pattern; // Interferenčný vzor (0-1)
-    
-    // Termodynamika
-    float entropy_density;      // Hustota entropie [J/K·m³]
-} OpticalNode;
+    // Horúce polia (10 B/bunka)
+    uint8_t *material_id;         // ID optického materiálu
+    uint8_t *boundary_distance;   // Vzdialenosť k rozhraniu materiálov
+    int32_t *photon_visits;       // Počet návštev
+    float *temperature;           // Teplota [K] (z absorpcie)
+    
+    // Studené polia
+    float *energy_density;        // Hustota energie [J/m³]
+    float *accumulated_phase;     // Kumulatívna fáza pre interferenciu
+    float *interference_pattern;  // Interferenčný vzor (0-1)
+    
+    int64_t home_cell;            // Index cieľa domov
+    int64_t bar_cell;             // Index cieľa bar
+    
+    // Procedurálny režim (--procedural): polia vyššie sa nealokujú
+    int procedural;               // 1 = materiál z hashu (seed, bunka)
+    uint64_t seed;                // Kľúč hashu materiálu a teploty
+    SparseCell *touched;          // Dotknuté bunky (otvorené adresovanie)
+    int64_t touched_capacity;     // Mocnina 2
+    int64_t touched_count;
+} OpticalWorld;
+
+#define WORLD_BYTES_PER_CELL (2 * sizeof(uint8_t) + sizeof(int32_t) + 4 * sizeof(float))
 
 typedef struct {
     float wavelength;           // Vlnová dĺžka [m]
@@ -90,6 +148,17 @@ typedef struct {
     float group_velocity;       // Skupinová rýchlosť [m/s]
 } Photon;
 
+/* Stav jedného fotónu na jeho dráhe svetom */
+typedef struct {
+    Photon photon;
+    int32_t pos_x, pos_y;
+    int32_t target_x, target_y;   // Aktuálny cieľ (po domove sa mení na bar)
+    float current_direction;      // Smer šírenia [rad]
+    int32_t direction_state;      // Index smeru v prechodových tabuľkách
+    int32_t uniform_run;          // Zvyšné kroky bez rozhodovania
+    float uniform_step;           // Dĺžka kroku v homogénnej oblasti [m]
+} PhotonState;
+
 typedef struct {
     // ENTROPICKÉ METRIKY (konzistentné s Human verziou)
     float information_entropy;    // S_info (bezrozmerná 0-1)
@@ -113,15 +182,100 @@ typedef struct {
     
 } SystemMetrics;
 
+/* Priebežné súčty pre entropie - aktualizované pri každej zmene bunky.
+ * Využíva identitu Σp·log p = (Σv·log v)/V - log V, takže snímka
+ * entropie nevyžaduje prechod cez celú mriežku. */
+typedef struct {
+    int64_t total_visits;         // Σ v
+    double visit_log_sum;         // Σ v·ln v
+    double total_temperature;     // Σ t [K]
+    double temperature_log_sum;   // Σ t·ln t
+    int64_t visited_cells;        // Počet buniek s v > 0
+} EntropyAccumulator;
+
 /* ==================== GLOBÁLNE PREMENNÉ ==================== */
 
-int32_t dimension;                // ZMENENÉ: int32_t pre veľké mriežky
-OpticalNode **world;              // 2D optický svet
-Photon photon;                    // Simulovaný fotón
-SystemMetrics metrics;            // Systémové metriky
+/* Stav jedného behu. Program má jeden, knižnica jeden na simuláciu a
+ * replikáty jeden na vlákno; kód k nemu pristupuje cez sim, ktorý každé
+ * vlákno nastaví na stav svojho behu. */
+struct SimulationState {
+    int32_t dimension;                // ZMENENÉ: int32_t pre veľké mriežky
+    OpticalWorld world;               // 2D optický svet (štruktúra polí)
+    Photon photon;                    // Simulovaný fotón
+    SystemMetrics metrics;            // Systémové metriky
+    EntropyAccumulator entropy_acc;   // Inkrementálne entropické súčty
+    
+    int32_t target_x, target_y;       // ZMENENÉ: int32_t
+    int32_t start_x, start_y;         // ZMENENÉ: int32_t
+    
+    int quiet;                        // --quiet: bez baneru, priebehu a správy, jeden riadok metrík
+    int empty_space_skip_enabled;     // --no-skip: rozhodovanie v každom kroku
+    int32_t world_init_threads;       // Vlákna inicializácie sveta
+    Arena world_arena;                // Polia sveta (ďalší beh ju použije znova)
+    WorldImage world_image;           // Namapovaný súbor --world-dir počas inicializácie
+    double background_temperature_mean;      // E[t] nedotknutej bunky
+    double background_temperature_log_mean;  // E[t·ln t] nedotknutej bunky
+    
+    // Ensemble režim (--photons N)
+    uint64_t ensemble_seed;           // Základ pre smery emisie fotónov
+    int64_t ensemble_steps;           // Kroky všetkých fotónov (priepustnosť)
+    int64_t ensemble_tiles_used;      // Privátne dlaždice všetkých vlákien
+    struct EnsembleWorker *ensemble_workers;
+    int64_t ensemble_next_photon;     // Atomický čítač ďalšieho fotónu
+    int64_t ensemble_tiles;           // Počet dlaždíc sveta
+};
+
+// Ensemble režim (--photons N)
+int64_t ensemble_photons = 1;     // Počet fotónov (1 = jeden fotón s výpisom)
+int32_t ensemble_threads = 0;     // 0 = všetky dostupné jadrá
+int init_only = 0;                // --init-only: iba meranie štartu
+int bench_entropy = 0;            // --bench-entropy: iba meranie jadra entropie
+
+// 8-susedná pre presnejšiu optiku
+/* Index bunky [x][y] v poliach sveta */
+static inline int64_t cell_index(int32_t x, int32_t y) {
+    return (int64_t)y * sim->dimension + x;
+}
+
+/* Náhodné bity bunky zo seedu sveta; index bunky je riadkový, procedurálny
+ * svet s rovnakým seedom je teda ten istý ako hustý */
+static inline uint64_t cell_hash(int64_t idx) {
+    return world_cell_hash(sim->world.seed, idx);
+}
+
+static inline float initial_temperature(int level) {
+    return 293.15 + level / 100.0 * 5.0;
+}
+
+static inline float cell_initial_temperature(uint64_t hash) {
+    return initial_temperature(cell_initial_temperature_level(hash));
+}
+
+/* Materiál procedurálnej bunky vrátane pevných cieľov. Nevkladá sa,
+ * aby hash nezaťažoval rozhodovaciu slučku hustého sveta. */
+__attribute__((noinline)) int procedural_material(int64_t idx) {
+    if (idx == sim->world.home_cell) return 2;
+    if (idx == sim->world.bar_cell) return 1;
+    return cell_initial_material(cell_hash(idx));
+}
+
+static inline int cell_material(int32_t x, int32_t y) {
+    if (__builtin_expect(sim->world.procedural, 0)) return procedural_material(cell_index(x, y));
+    return sim->world.material_id[cell_index(x, y)];
+}
+
+/* Cieľ v bunke: 0 = žiadny, 1 = domov, 2 = bar */
+static inline int cell_target(int32_t x, int32_t y) {
+    int64_t idx = cell_index(x, y);
+    if (idx == sim->world.home_cell) return 1;
+    if (idx == sim->world.bar_cell) return 2;
+    return 0;
+}
 
-int32_t target_x, target_y;       // ZMENENÉ: int32_t
-int32_t start_x, start_y;         // ZMENENÉ: int32_t
+const int32_t direction_dx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int32_t direction_dy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+const float direction_angles[8] = {0.0, M_PI/4, M_PI/2, 3*M_PI/4,
+                                   M_PI, 5*M_PI/4, 3*M_PI/2, 7*M_PI/4};
 
 /* ==================== OPTICKÉ FUNKCIE ==================== */
 
@@ -167,19 +321,53 @@ float optical_distance(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
     float geometric = sqrt(dx*dx + dy*dy);
     
     // Optická dráha = geometrická × index lomu
-    OpticalMaterial mat = materials[world[x2][y2].material_id];
+    OpticalMaterial mat = materials[cell_material(x2, y2)];
     return geometric * mat.refractive_index;
 }
 
+/* Váha smeru bez cieľového členu - závisí iba od dvojice materiálov
+ * a uhla dopadu, preto ju možno predpočítať do prechodových tabuliek */
+float transition_material_weight(int from_material, int to_material,
+                                 float direction_angle, float current_direction) {
+    OpticalMaterial current_mat = materials[from_material];
+    OpticalMaterial next_mat = materials[to_material];
+    float weight = 0.0;
+    
+    // 1. Snellov zákon (60% váha)
+    float angle_diff = fabs(direction_angle - current_direction);
+    if (angle_diff > M_PI) angle_diff = 2*M_PI - angle_diff;
+    
+    float refraction_angle = snell_law(current_mat.refractive_index,
+                                      next_mat.refractive_index,
+                                      angle_diff);
+    
+    if (refraction_angle >= 0) {
+        // Úspešný lom
+        weight += 0.6 * (1.0 - fabs(refraction_angle) / (M_PI/2));
+    } else {
+        // Totálny odraz - nižšia váha
+        weight += 0.2;
+    }
+    
+    // 2. Fresnelove odrazy (20% váha)
+    float R = fresnel_reflection(current_mat.refractive_index,
+                                next_mat.refractive_index);
+    weight += 0.2 * (1.0 - R); // Preferencia priechodnosti
+    
+    // 3. Absorpcia (10% váha) - penalizácia
+    float absorption_loss = next_mat.absorption_coeff * CELL_SIZE;
+    weight -= 0.1 * absorption_loss;
+    
+    return weight;
+}
+
 /* Optický prechod s fyzikálnymi zákonmi */
-int32_t optical_transition_decision(int32_t x, int32_t y, float current_direction) {
-    // 8-susedná pre presnejšiu optiku
-    int32_t dx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
-    int32_t dy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-    float angles[8] = {0.0, M_PI/4, M_PI/2, 3*M_PI/4, 
-                      M_PI, 5*M_PI/4, 3*M_PI/2, 7*M_PI/4};
-    
-    OpticalMaterial current_mat = materials[world[x][y].material_id];
+int32_t optical_transition_decision(int32_t x, int32_t y, float current_direction,
+                                    int32_t target_x, int32_t target_y) {
+    const int32_t *dx = direction_dx;
+    const int32_t *dy = direction_dy;
+    const float *angles = direction_angles;
+    
     float weights[8] = {0};
     int32_t valid_dirs = 0;
     
@@ -188,38 +376,15 @@ int32_t optical_transition_decision(int32_t x, int32_t y, float current_directio
         int32_t ny = y + dy[i];
         
         // Kontrola hraníc
-        if (nx < 0 || nx >= dimension || ny < 0 || ny >= dimension) {
+        if (nx < 0 || nx >= sim->dimension || ny < 0 || ny >= sim->dimension) {
             weights[i] = -INFINITY;
             continue;
         }
         
         valid_dirs++;
-        OpticalMaterial next_mat = materials[world[nx][ny].material_id];
-        
-        // 1. Snellov zákon (60% váha)
-        float angle_diff = fabs(angles[i] - current_direction);
-        if (angle_diff > M_PI) angle_diff = 2*M_PI - angle_diff;
-        
-        float refraction_angle = snell_law(current_mat.refractive_index,
-                                          next_mat.refractive_index,
-                                          angle_diff);
-        
-        if (refraction_angle >= 0) {
-            // Úspešný lom
-            weights[i] += 0.6 * (1.0 - fabs(refraction_angle) / (M_PI/2));
-        } else {
-            // Totálny odraz - nižšia váha
-            weights[i] += 0.2;
-        }
-        
-        // 2. Fresnelove odrazy (20% váha)
-        float R = fresnel_reflection(current_mat.refractive_index,
-                                    next_mat.refractive_index);
-        weights[i] += 0.2 * (1.0 - R); // Preferencia priechodnosti
-        
-        // 3. Absorpcia (10% váha) - penalizácia
-        float absorption_loss = next_mat.absorption_coeff * CELL_SIZE;
-        weights[i] -= 0.1 * absorption_loss;
+        weights[i] = transition_material_weight(cell_material(x, y),
+                                                cell_material(nx, ny),
+                                                angles[i], current_direction);
         
         // 4. Smer k cieľu (10% váha)
         float target_angle = atan2(target_y - y, target_x - x);
@@ -241,34 +406,273 @@ int32_t optical_transition_decision(int32_t x, int32_t y, float current_directio
     return best_dir;
 }
 
-/* ==================== OPRAVENÝ VÝPOČET ENTROPIÍ ==================== */
+/* ==================== PRECHODOVÉ TABUĽKY ==================== */
 
-/* Informačná entropia z rozloženia fotónov */
-float calculate_information_entropy() {
-    int64_t total_visits = 0;
+/* Po prvom kroku nadobúda smer fotónu iba konečne veľa hodnôt: uhol
+ * jedného z 8 smerov, jeho odraz (-uhol), alebo uhol lomu pri vstupe
+ * smerom d z materiálu a do materiálu b. Váha každého smeru pre každý
+ * taký stav a dvojicu materiálov sa vypočíta raz pri štarte. */
+#define MATERIAL_COUNT 5
+#define DIRECTION_STATES (16 + MATERIAL_COUNT * MATERIAL_COUNT * 8)
+#define DIRECTION_FREE -1         // Ľubovoľný uhol (emisia) - bez tabuľky
+
+typedef struct {
+    // [stav smeru][materiál bunky][smer][materiál suseda]
+    float weight[DIRECTION_STATES][MATERIAL_COUNT][8][MATERIAL_COUNT];
+    float state_angle[DIRECTION_STATES];
+    // Stav po kroku smerom d z materiálu a do materiálu b
+    int16_t next_state[MATERIAL_COUNT][MATERIAL_COUNT][8];
+} TransitionTables;
+
+TransitionTables transition_tables;
+int transition_tables_enabled = 1;  // --no-tables: priamy výpočet
+
+void init_transition_tables() {
+    TransitionTables *t = &transition_tables;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            total_visits += world[x][y].photon_visits;
+    for (int d = 0; d < 8; d++) {
+        t->state_angle[d] = direction_angles[d];
+        t->state_angle[8 + d] = -direction_angles[d];
+    }
+    
+    // Rovnaký výpočet ako v photon_move, aby uhly sedeli bit po bite
+    for (int a = 0; a < MATERIAL_COUNT; a++) {
+        for (int b = 0; b < MATERIAL_COUNT; b++) {
+            for (int d = 0; d < 8; d++) {
+                int refraction_state = 16 + (a * MATERIAL_COUNT + b) * 8 + d;
+                float refraction_angle = snell_law(materials[a].refractive_index,
+                                                   materials[b].refractive_index,
+                                                   fabs(direction_angles[d]));
+                t->state_angle[refraction_state] = refraction_angle;
+                
+                if (materials[a].refractive_index == materials[b].refractive_index) {
+                    t->next_state[a][b][d] = d;
+                } else if (refraction_angle >= 0) {
+                    t->next_state[a][b][d] = refraction_state;
+                } else {
+                    t->next_state[a][b][d] = 8 + d;
+                }
+            }
         }
     }
     
-    if (total_visits == 0) return 0.0;
+    for (int s = 0; s < DIRECTION_STATES; s++) {
+        for (int a = 0; a < MATERIAL_COUNT; a++) {
+            for (int i = 0; i < 8; i++) {
+                for (int b = 0; b < MATERIAL_COUNT; b++) {
+                    t->weight[s][a][i][b] = transition_material_weight(a, b, direction_angles[i],
+                                                                       t->state_angle[s]);
+                }
+            }
+        }
+    }
+}
+
+/* optical_transition_decision pre fotón so známym stavom smeru:
+ * materiálové členy sú vyhľadanie v tabuľke, počíta sa iba smer k cieľu */
+KERNEL_INLINE int32_t table_transition_decision_body(int32_t x, int32_t y, int32_t state,
+                                                      int32_t target_x, int32_t target_y) {
+    const float (*material_weight)[MATERIAL_COUNT] =
+        transition_tables.weight[state][cell_material(x, y)];
+    float target_angle = atan2(target_y - y, target_x - x);
+    float weights[8];
+    int32_t valid_dirs = 0;
+    
+    for (int32_t i = 0; i < 8; i++) {
+        int32_t nx = x + direction_dx[i];
+        int32_t ny = y + direction_dy[i];
+        
+        if (nx < 0 || nx >= sim->dimension || ny < 0 || ny >= sim->dimension) {
+            weights[i] = -INFINITY;
+            continue;
+        }
+        
+        valid_dirs++;
+        weights[i] = material_weight[i][cell_material(nx, ny)];
+        
+        float target_diff = fabs(direction_angles[i] - target_angle);
+        if (target_diff > M_PI) target_diff = 2*M_PI - target_diff;
+        weights[i] += 0.1 * (1.0 - target_diff / M_PI);
+    }
+    
+    if (valid_dirs == 0) return -1;
+    
+    int32_t best_dir = 0;
+    for (int32_t i = 1; i < 8; i++) {
+        if (weights[i] > weights[best_dir]) {
+            best_dir = i;
+        }
+    }
+    
+    return best_dir;
+}
+
+KERNEL_VARIANTS(int32_t, table_transition_decision,
+                (int32_t x, int32_t y, int32_t state, int32_t target_x, int32_t target_y),
+                (x, y, state, target_x, target_y))
+
+/* ==================== PRESKAKOVANIE HOMOGÉNNYCH OBLASTÍ ==================== */
+
+/* Homogénna bunka má všetkých susedov vo svete z rovnakého materiálu.
+ * Pole boundary_distance drží šachovnicovú vzdialenosť bunky k najbližšej
+ * nehomogénnej bunke (okraj sveta sa za rozhranie nepočíta). Fotón idúci
+ * rovno z bunky so vzdialenosťou k prejde k-1 krokov iba cez homogénne
+ * bunky, kde sú materiálové členy váh konštantné a mení sa iba uhol
+ * k cieľu. Ten sa pozdĺž priamky mení monotónne, takže stačí porovnať
+ * rezervu víťazného smeru so zmenou cieľového členu medzi koncami úseku. */
+#define SKIP_MAX_DISTANCE 255
+#define SKIP_MARGIN_EPSILON 1e-5  // Rezerva na zaokrúhlenie váh vo float
+
+/* Minimum zo vzdialenosti bunky a suseda (dx, dy) zväčšenej o 1 */
+static inline int boundary_relax(int distance, int32_t x, int32_t y, int32_t dx, int32_t dy) {
+    int32_t nx = x + dx;
+    int32_t ny = y + dy;
+    if (nx < 0 || nx >= sim->dimension || ny < 0 || ny >= sim->dimension) return distance;
+    
+    int neighbor = sim->world.boundary_distance[cell_index(nx, ny)] + 1;
+    return neighbor < distance ? neighbor : distance;
+}
+
+/* Dvojprechodová transformácia vzdialenosti; vráti počet homogénnych buniek */
+int64_t init_boundary_distance() {
+    uint8_t *distance = sim->world.boundary_distance;
+    const uint8_t *material = sim->world.material_id;
+    int64_t uniform_cells = 0;
+    
+    for (int32_t y = 0; y < sim->dimension; y++) {
+        for (int32_t x = 0; x < sim->dimension; x++) {
+            int64_t idx = cell_index(x, y);
+            int uniform = 1;
+            for (int32_t i = 0; uniform && i < 8; i++) {
+                int32_t nx = x + direction_dx[i];
+                int32_t ny = y + direction_dy[i];
+                if (nx < 0 || nx >= sim->dimension || ny < 0 || ny >= sim->dimension) continue;
+                uniform = material[cell_index(nx, ny)] == material[idx];
+            }
+            distance[idx] = uniform ? SKIP_MAX_DISTANCE : 0;
+            uniform_cells += uniform;
+        }
+    }
+    
+    // Dopredný prechod (susedia vľavo a v riadku nad), potom spätný
+    for (int32_t y = 0; y < sim->dimension; y++) {
+        for (int32_t x = 0; x < sim->dimension; x++) {
+            int64_t idx = cell_index(x, y);
+            if (!distance[idx]) continue;
+            int d = distance[idx];
+            d = boundary_relax(d, x, y, -1, 0);
+            d = boundary_relax(d, x, y, -1, -1);
+            d = boundary_relax(d, x, y, 0, -1);
+            d = boundary_relax(d, x, y, 1, -1);
+            distance[idx] = d;
+        }
+    }
+    for (int32_t y = sim->dimension - 1; y >= 0; y--) {
+        for (int32_t x = sim->dimension - 1; x >= 0; x--) {
+            int64_t idx = cell_index(x, y);
+            if (!distance[idx]) continue;
+            int d = distance[idx];
+            d = boundary_relax(d, x, y, 1, 0);
+            d = boundary_relax(d, x, y, 1, 1);
+            d = boundary_relax(d, x, y, 0, 1);
+            d = boundary_relax(d, x, y, -1, 1);
+            distance[idx] = d;
+        }
+    }
     
-    float entropy = 0.0;
-    float log2 = log(2.0);
+    return uniform_cells;
+}
+
+/* Smer i vedie mimo sveta z oboch koncov úseku, a teda z každej jeho bunky */
+static inline int direction_blocked_on_run(int32_t i, int32_t x0, int32_t y0,
+                                           int32_t x1, int32_t y1) {
+    int32_t last = sim->dimension - 1;
+    return (direction_dx[i] < 0 && x0 == 0 && x1 == 0) ||
+           (direction_dx[i] > 0 && x0 == last && x1 == last) ||
+           (direction_dy[i] < 0 && y0 == 0 && y1 == 0) ||
+           (direction_dy[i] > 0 && y0 == last && y1 == last);
+}
+
+/* Počet ďalších krokov smerom d, v ktorých table_transition_decision
+ * s rovnakým stavom určite opäť vyberie d (0 = rozhodovať ďalej).
+ * Volá sa pre fotón, ktorý práve vybral smer d v stave d. */
+int32_t uniform_run_length(const PhotonState *ps, int32_t d) {
+    int64_t idx = cell_index(ps->pos_x, ps->pos_y);
+    int32_t run = sim->world.boundary_distance[idx] - 1;
+    if (run <= 0) return 0;
+    
+    // Cieľový člen rovnakým výpočtom ako v rozhodovaní
+    const float (*material_weight)[MATERIAL_COUNT] =
+        transition_tables.weight[d][sim->world.material_id[idx]];
+    int material = sim->world.material_id[idx];
+    float target_angle = atan2(ps->target_y - ps->pos_y, ps->target_x - ps->pos_x);
+    float weights[8];
+    
+    for (int32_t i = 0; i < 8; i++) {
+        float target_diff = fabs(direction_angles[i] - target_angle);
+        if (target_diff > M_PI) target_diff = 2*M_PI - target_diff;
+        weights[i] = material_weight[i][material] + 0.1 * (1.0 - target_diff / M_PI);
+    }
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            float p = (float)world[x][y].photon_visits / total_visits;
-            if (p > 0.0) {
-                entropy -= p * (log(p) / log2);
+    while (run > 0) {
+        // Posledné preskočené rozhodnutie je v bunke end, presun z nej
+        // musí zostať vo svete
+        int32_t end_x = ps->pos_x + direction_dx[d] * run;
+        int32_t end_y = ps->pos_y + direction_dy[d] * run;
+        int32_t exit_x = end_x + direction_dx[d];
+        int32_t exit_y = end_y + direction_dy[d];
+        
+        if (exit_x >= 0 && exit_x < sim->dimension && exit_y >= 0 && exit_y < sim->dimension) {
+            // Smery mimo sveta majú v celom úseku váhu -INFINITY
+            float runner_up = -INFINITY;
+            for (int32_t i = 0; i < 8; i++) {
+                if (i == d || direction_blocked_on_run(i, ps->pos_x, ps->pos_y, end_x, end_y)) continue;
+                if (weights[i] > runner_up) runner_up = weights[i];
             }
+            
+            // Cieľový člen každého smeru sa zmení najviac o 0.1·Δθ/π
+            double end_angle = atan2(ps->target_y - end_y, ps->target_x - end_x);
+            double sweep = fabs(end_angle - target_angle);
+            if (sweep > M_PI) sweep = 2*M_PI - sweep;
+            
+            if (weights[d] - runner_up - 0.2 * sweep / M_PI > SKIP_MARGIN_EPSILON) return run;
         }
+        run /= 2;
     }
     
-    // Normalizácia na rozsah 0-1
-    float max_entropy = log(dimension * dimension) / log2;
+    return 0;
+}
+
+/* ==================== OPRAVENÝ VÝPOČET ENTROPIÍ ==================== */
+
+/* x·ln x s limitou 0 pre x = 0 */
+static inline double xlogx(double x) {
+    return x > 0.0 ? x * log(x) : 0.0;
+}
+
+/* Návšteva bunky: v → v+1 */
+void entropy_acc_visit(int32_t old_visits) {
+    sim->entropy_acc.total_visits++;
+    sim->entropy_acc.visit_log_sum += xlogx(old_visits + 1.0) - xlogx(old_visits);
+    if (old_visits == 0) sim->entropy_acc.visited_cells++;
+}
+
+/* Zmena teploty bunky: t → t' */
+void entropy_acc_temperature(float old_temperature, float new_temperature) {
+    sim->entropy_acc.total_temperature += (double)new_temperature - old_temperature;
+    sim->entropy_acc.temperature_log_sum += xlogx(new_temperature) - xlogx(old_temperature);
+}
+
+/* Informačná entropia z rozloženia fotónov - O(1) z akumulátorov */
+float calculate_information_entropy() {
+    if (sim->entropy_acc.total_visits == 0) return 0.0;
+    
+    // -Σp·ln p = ln V - (Σv·ln v)/V
+    double V = (double)sim->entropy_acc.total_visits;
+    double entropy = log(V) - sim->entropy_acc.visit_log_sum / V;
+    
+    // Normalizácia na rozsah 0-1 (log₂ sa v pomere vykráti)
+    double max_entropy = log((double)sim->dimension * sim->dimension);
     if (max_entropy > 0.0) {
         entropy /= max_entropy;
     }
@@ -277,52 +681,118 @@ float calculate_information_entropy() {
     if (entropy < 0.0) entropy = 0.0;
     if (entropy > 1.0) entropy = 1.0;
     
-    metrics.information_entropy = entropy;
+    sim->metrics.information_entropy = entropy;
     return entropy;
 }
 
-/* Tepelná entropia z rozloženia teploty */
+/* Tepelná entropia z rozloženia teploty - O(1) z akumulátorov */
 float calculate_thermal_entropy() {
-    float total_energy = 0.0;
-    int64_t cells = dimension * dimension;
+    if (sim->entropy_acc.total_temperature <= 0.0) return 0.0;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            total_energy += world[x][y].temperature;
-        }
+    // -Σp·ln p = ln T - (Σt·ln t)/T
+    double T = sim->entropy_acc.total_temperature;
+    double entropy = log(T) - sim->entropy_acc.temperature_log_sum / T;
+    
+    // Normalizácia
+    double max_entropy = log((double)sim->dimension * sim->dimension);
+    if (max_entropy > 0.0) {
+        entropy /= max_entropy;
+    }
+    
+    // Obmedzenie na rozsah 0-1
+    if (entropy < 0.0) entropy = 0.0;
+    if (entropy > 1.0) entropy = 1.0;
+    
+    sim->metrics.thermal_entropy = entropy;
+    return entropy;
+}
+
+/* Pôvodný dvojprechod poľom teplôt - referencia pre --bench-entropy */
+float calculate_thermal_entropy_rescan() {
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    double total_energy = 0.0;
+    
+    for (int64_t i = 0; i < cells; i++) {
+        total_energy += sim->world.temperature[i];
     }
     
     if (total_energy <= 0.0) return 0.0;
     
-    float entropy = 0.0;
+    double entropy = 0.0;
     
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            float p = world[x][y].temperature / total_energy;
-            if (p > 0.0) {
-                entropy -= p * log(p);
-            }
+    for (int64_t i = 0; i < cells; i++) {
+        double p = sim->world.temperature[i] / total_energy;
+        if (p > 0.0) {
+            entropy -= p * log(p);
         }
     }
     
-    // Normalizácia
-    float max_entropy = log(cells);
+    double max_entropy = log((double)sim->dimension * sim->dimension);
+    if (max_entropy > 0.0) {
+        entropy /= max_entropy;
+    }
+    
+    if (entropy < 0.0) entropy = 0.0;
+    if (entropy > 1.0) entropy = 1.0;
+    
+    return entropy;
+}
+
+#ifdef DEBUG
+/* Pôvodný úplný prechod mriežkou - iba na krížovú kontrolu akumulátorov */
+float calculate_information_entropy_rescan() {
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    int64_t total_visits = 0;
+    
+    for (int64_t i = 0; i < cells; i++) {
+        total_visits += sim->world.photon_visits[i];
+    }
+    
+    if (total_visits == 0) return 0.0;
+    
+    double entropy = 0.0;
+    
+    for (int64_t i = 0; i < cells; i++) {
+        double p = (double)sim->world.photon_visits[i] / total_visits;
+        if (p > 0.0) {
+            entropy -= p * log(p);
+        }
+    }
+    
+    double max_entropy = log((double)sim->dimension * sim->dimension);
     if (max_entropy > 0.0) {
         entropy /= max_entropy;
     }
     
-    // Obmedzenie na rozsah 0-1
     if (entropy < 0.0) entropy = 0.0;
     if (entropy > 1.0) entropy = 1.0;
     
-    metrics.thermal_entropy = entropy;
     return entropy;
 }
 
+float thermal_entropy_kernel();
+
+/* Porovnanie akumulátorov s úplným prechodom (debug build) */
+void entropy_cross_check(const char* where) {
+    // Pozadie procedurálneho sveta je implicitné, nie je čo prechádzať
+    if (sim->world.procedural) return;
+    
+    float info_inc = calculate_information_entropy();
+    float therm_inc = calculate_thermal_entropy();
+    float info_full = calculate_information_entropy_rescan();
+    float therm_full = thermal_entropy_kernel();
+    
+    if (fabs(info_inc - info_full) > 1e-4 || fabs(therm_inc - therm_full) > 1e-4) {
+        printf("[DEBUG] %s: nesúlad entropií S_info %.6f/%.6f, S_therm %.6f/%.6f\n",
+               where, info_inc, info_full, therm_inc, therm_full);
+    }
+}
+#endif
+
 /* Kvantová entropia (koherencia fotónového stavu) */
-float calculate_quantum_entropy() {
-    float total_interactions = photon.reflections + photon.refractions;
-    float max_possible_interactions = dimension * 2;
+float calculate_quantum_entropy(const Photon *p) {
+    float total_interactions = p->reflections + p->refractions;
+    float max_possible_interactions = sim->dimension * 2;
     
     float coherence = 1.0 - (total_interactions / max_possible_interactions);
     if (coherence < 0.0) coherence = 0.0;
@@ -332,360 +802,1819 @@ float calculate_quantum_entropy() {
     if (quantum_entropy < 0.0) quantum_entropy = 0.0;
     if (quantum_entropy > 1.0) quantum_entropy = 1.0;
     
-    metrics.quantum_entropy = quantum_entropy;
+    sim->metrics.quantum_entropy = quantum_entropy;
     return quantum_entropy;
 }
 
-/* ==================== INICIALIZÁCIA ==================== */
+/* ==================== PROCEDURÁLNY SVET ==================== */
 
-void init_optical_world(int32_t dim) {
-    dimension = dim;
-    
-    // Dynamická alokácia pamäte pre veľkú mriežku
-    world = (OpticalNode**)malloc(dimension * sizeof(OpticalNode*));
-    if (!world) {
-        printf("Chyba: Nedostatok pamäte pre %"PRId32" riadkov\n", dimension);
+/* Materiál aj počiatočná teplota bunky sú bezstavové funkcie hashu
+ * (seed, index bunky). Ukladajú sa iba bunky, ktoré fotón navštívil,
+ * v hašovacej tabuľke s lineárnym skúšaním, takže pamäť aj štart
+ * rastú s dĺžkou dráhy, nie s plochou sveta. Entropické akumulátory
+ * začínajú s očakávaným príspevkom nedotknutého pozadia a pri prvom
+ * dotyku bunky ho nahradia jej skutočnou teplotou. */
+#define TOUCHED_INITIAL_CAPACITY 65536
+
+/* Ukazovatele na stav bunky - husté polia alebo záznam dotknutej bunky.
+ * Platia iba do ďalšieho vloženia do tabuľky (zväčšenie ju presúva). */
+typedef struct {
+    int32_t *photon_visits;
+    float *temperature;
+    float *energy_density;
+    float *accumulated_phase;
+    float *interference_pattern;
+} CellRef;
+
+/* Slot bunky v tabuľke dotknutých buniek (Fibonacciho hash) */
+static inline int64_t touched_slot(int64_t idx, int64_t capacity) {
+    return (int64_t)(((uint64_t)idx * 0x9E3779B97F4A7C15ULL) >> 17) & (capacity - 1);
+}
+
+void touched_alloc(int64_t capacity) {
+    sim->world.touched = malloc(capacity * sizeof(SparseCell));
+    if (!sim->world.touched) {
+        printf("Chyba: Nedostatok pamäte pre %"PRId64" dotknutých buniek\n", capacity);
         exit(1);
     }
-    
-    for (int32_t i = 0; i < dimension; i++) {
-        world[i] = (OpticalNode*)malloc(dimension * sizeof(OpticalNode));
-        if (!world[i]) {
-            printf("Chyba: Nedostatok pamäte pre %"PRId32" stĺpcov\n", dimension);
-            exit(1);
-        }
+    for (int64_t i = 0; i < capacity; i++) {
+        sim->world.touched[i].cell = -1;
     }
-    
-    // Fyzikálne korektná inicializácia
-    printf("Inicializujem optický svet %"PRId32"x%"PRId32" (%"PRId64" buniek)...\n", 
-           dimension, dimension, (int64_t)dimension * dimension);
-    
-    for (int32_t y = 0; y < dimension; y++) {
-        for (int32_t x = 0; x < dimension; x++) {
-            world[x][y].x = x;
-            world[x][y].y = y;
-            world[x][y].photon_visits = 0;
-            world[x][y].energy_density = 0.0;
-            world[x][y].temperature = 293.15 + (rand() % 100) / 100.0 * 5.0;
-            world[x][y].optical_depth = 0.0;
-            world[x][y].accumulated_phase = 0.0;
-            world[x][y].interference_pattern = 0.0;
-            world[x][y].entropy_density = 0.0;
-            world[x][y].is_target = 0;
-            
-            // Náhodné priradenie optického materiálu
-            float r = (rand() % 1000) / 1000.0;
-            if (r < 0.40) {
-                world[x][y].material_id = 0; // vzduch
-            } else if (r < 0.70) {
-                world[x][y].material_id = 1; // voda
-            } else if (r < 0.90) {
-                world[x][y].material_id = 2; // sklo
-            } else if (r < 0.97) {
-                world[x][y].material_id = 3; // diamant
-            } else {
-                world[x][y].material_id = 4; // prekážka
-            }
-            
-            OpticalMaterial mat = materials[world[x][y].material_id];
-            world[x][y].optical_depth = mat.extinction_coeff * CELL_SIZE;
+    sim->world.touched_capacity = capacity;
+}
+
+/* Zdvojnásobenie tabuľky pri zaplnení nad 1/2 */
+void touched_grow() {
+    SparseCell *old = sim->world.touched;
+    int64_t old_capacity = sim->world.touched_capacity;
+    touched_alloc(old_capacity * 2);
+    
+    for (int64_t i = 0; i < old_capacity; i++) {
+        if (old[i].cell < 0) continue;
+        int64_t slot = touched_slot(old[i].cell, sim->world.touched_capacity);
+        while (sim->world.touched[slot].cell >= 0) {
+            slot = (slot + 1) & (sim->world.touched_capacity - 1);
         }
+        sim->world.touched[slot] = old[i];
+    }
+    free(old);
+}
+
+/* Záznam bunky; pri prvom dotyku sa vytvorí z hashu */
+SparseCell* touched_cell(int64_t idx) {
+    int64_t mask = sim->world.touched_capacity - 1;
+    int64_t slot = touched_slot(idx, sim->world.touched_capacity);
+    
+    while (sim->world.touched[slot].cell >= 0) {
+        if (sim->world.touched[slot].cell == idx) return &sim->world.touched[slot];
+        slot = (slot + 1) & mask;
     }
     
-    // Ciele s fyzikálnou interpretáciou
-    world[0][0].material_id = 2;
-    world[0][0].is_target = 1;
+    if (2 * (sim->world.touched_count + 1) > sim->world.touched_capacity) {
+        touched_grow();
+        return touched_cell(idx);
+    }
     
-    world[dimension-1][dimension-1].material_id = 1;
-    world[dimension-1][dimension-1].is_target = 2;
+    SparseCell *c = &sim->world.touched[slot];
+    c->cell = idx;
+    c->photon_visits = 0;
+    c->temperature = cell_initial_temperature(cell_hash(idx));
+    c->energy_density = 0.0;
+    c->accumulated_phase = 0.0;
+    c->interference_pattern = 0.0;
+    sim->world.touched_count++;
+    
+    // Očakávaný príspevok pozadia -> skutočná teplota bunky
+    sim->entropy_acc.total_temperature += (double)c->temperature - sim->background_temperature_mean;
+    sim->entropy_acc.temperature_log_sum += xlogx(c->temperature) - sim->background_temperature_log_mean;
+    return c;
 }
 
-void init_photon() {
-    photon.wavelength = WAVELENGTH;
-    photon.intensity = 1.0;
-    photon.phase = 0.0;
-    photon.polarization[0] = 1.0;
-    photon.polarization[1] = 0.0;
-    photon.coherence_length = 1.0e-3;
-    photon.optical_path_length = 0.0;
-    photon.reflections = 0;
-    photon.refractions = 0;
-    photon.accumulated_phase = 0.0;
-    photon.group_velocity = SPEED_OF_LIGHT / materials[world[start_x][start_y].material_id].refractive_index;
+static inline CellRef world_cell(int64_t idx) {
+    CellRef ref;
+    if (sim->world.procedural) {
+        SparseCell *c = touched_cell(idx);
+        ref.photon_visits = &c->photon_visits;
+        ref.temperature = &c->temperature;
+        ref.energy_density = &c->energy_density;
+        ref.accumulated_phase = &c->accumulated_phase;
+        ref.interference_pattern = &c->interference_pattern;
+    } else {
+        ref.photon_visits = &sim->world.photon_visits[idx];
+        ref.temperature = &sim->world.temperature[idx];
+        ref.energy_density = &sim->world.energy_density[idx];
+        ref.accumulated_phase = &sim->world.accumulated_phase[idx];
+        ref.interference_pattern = &sim->world.interference_pattern[idx];
+    }
+    return ref;
 }
 
-void init_metrics() {
-    metrics.information_entropy = 0.0;
-    metrics.thermal_entropy = 0.0;
-    metrics.quantum_entropy = 0.0;
-    
-    metrics.total_optical_path = 0.0;
-    metrics.average_intensity = 0.0;
-    metrics.photon_efficiency = 0.0;
+void init_procedural_world(int32_t dim) {
+    sim->dimension = dim;
+    memset(&sim->entropy_acc, 0, sizeof(sim->entropy_acc));
+    sim->world.procedural = 1;
+    sim->world.home_cell = cell_index(0, 0);
+    sim->world.bar_cell = cell_index(sim->dimension-1, sim->dimension-1);
+    touched_alloc(TOUCHED_INITIAL_CAPACITY);
+    
+    if (!sim->quiet) {
+        printf("Inicializujem procedurálny optický svet %"PRId32"x%"PRId32" (%"PRId64" buniek, "
+               "ukladajú sa iba dotknuté)...\n", sim->dimension, sim->dimension, (int64_t)sim->dimension * sim->dimension);
+    }
     
-    metrics.total_energy_absorbed = 0.0;
-    metrics.max_temperature = 0.0;
-    metrics.min_temperature = 1000.0;
+    // Stredné hodnoty t a t·ln t cez 100 možných počiatočných teplôt
+    sim->background_temperature_mean = 0.0;
+    sim->background_temperature_log_mean = 0.0;
+    for (int level = 0; level < INITIAL_TEMPERATURE_LEVELS; level++) {
+        float t = initial_temperature(level);
+        sim->background_temperature_mean += t / INITIAL_TEMPERATURE_LEVELS;
+        sim->background_temperature_log_mean += xlogx(t) / INITIAL_TEMPERATURE_LEVELS;
+    }
     
-    metrics.total_cells = (int64_t)dimension * dimension;
-    metrics.visited_cells = 0;
-    metrics.coverage = 0.0;
+    double cells = (double)sim->dimension * sim->dimension;
+    sim->entropy_acc.total_temperature = cells * sim->background_temperature_mean;
+    sim->entropy_acc.temperature_log_sum = cells * sim->background_temperature_log_mean;
 }
 
-/* ==================== HLAVNÁ OPTICKÁ SIMULÁCIA ==================== */
+/* ==================== INICIALIZÁCIA ==================== */
 
-void simulate_photon_propagation() {
-    int32_t pos_x = start_x;
-    int32_t pos_y = start_y;
-    float current_direction = atan2(target_y - start_y, target_x - start_x);
-    
-    printf("\n[KYBERNAUT-LIGHT v3.1] Fyzikálne korektná optická simulácia\n");
-    printf("==============================================================\n");
-    printf("Optické parametre:\n");
-    printf("  • Vlnová dĺžka: %.1f nm\n", WAVELENGTH * 1e9);
-    printf("  • Bunka: %.1f µm\n", CELL_SIZE * 1e6);
-    printf("  • Časový krok: %.1f fs\n", TIME_STEP * 1e15);
-    printf("  • Energie fotónu: %.3e J\n", PHOTON_ENERGY);
-    printf("  • Rozmer sveta: %"PRId32"x%"PRId32"\n", dimension, dimension);
-    printf("==============================================================\n");
-    
-    int32_t last_print = 0;
-    float cumulative_intensity = photon.intensity;
-    
-    while (photon.optical_path_length < MAX_STEPS * CELL_SIZE && 
-           photon.intensity > 1e-6) {
-        
-        world[pos_x][pos_y].photon_visits++;
-        
-        world[pos_x][pos_y].accumulated_phase += photon.phase;
-        world[pos_x][pos_y].interference_pattern = 
-            0.5 + 0.5 * cos(world[pos_x][pos_y].accumulated_phase);
-        
-        OpticalMaterial mat = materials[world[pos_x][pos_y].material_id];
-        float absorbed = photon.intensity * mat.absorption_coeff * CELL_SIZE;
-        world[pos_x][pos_y].energy_density += absorbed;
-        world[pos_x][pos_y].temperature += absorbed * 100.0;
-        metrics.total_energy_absorbed += absorbed * PHOTON_ENERGY;
-        
-        photon.intensity = beer_lambert_absorption(
-            photon.intensity, 
-            mat.extinction_coeff, 
-            CELL_SIZE
-        );
-        
-        if (world[pos_x][pos_y].temperature > metrics.max_temperature) {
-            metrics.max_temperature = world[pos_x][pos_y].temperature;
-        }
-        if (world[pos_x][pos_y].temperature < metrics.min_temperature) {
-            metrics.min_temperature = world[pos_x][pos_y].temperature;
-        }
-        
-        int32_t direction = optical_transition_decision(pos_x, pos_y, current_direction);
-        
-        if (direction == -1) {
-            break;
-        }
-        
-        int32_t dx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
-        int32_t dy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-        float angles[8] = {0.0, M_PI/4, M_PI/2, 3*M_PI/4, 
-                          M_PI, 5*M_PI/4, 3*M_PI/2, 7*M_PI/4};
-        
-        int32_t new_x = pos_x + dx[direction];
-        int32_t new_y = pos_y + dy[direction];
-        current_direction = angles[direction];
+#define INIT_BLOCK_ROWS 64        // Riadky v jednom bloku inicializácie
+
+/* Vlákno inicializácie: bloky riadkov first_block + k·block_stride */
+typedef struct {
+    pthread_t thread;
+    int32_t first_block, block_stride;
+    EntropyAccumulator *block_acc;  // Súčty akumulátorov po blokoch
+} WorldInitWorker;
+
+void* world_init_worker(void *arg) {
+    WorldInitWorker *w = (WorldInitWorker*)arg;
+    
+    for (int32_t b = w->first_block; b * INIT_BLOCK_ROWS < sim->dimension; b += w->block_stride) {
+        int32_t row_end = (b + 1) * INIT_BLOCK_ROWS;
+        if (row_end > sim->dimension) row_end = sim->dimension;
         
-        if (new_x < 0 || new_x >= dimension || new_y < 0 || new_y >= dimension) {
-            break;
-        }
+        // Riadky bloku sú súvislý úsek polí
+        int64_t begin = cell_index(0, b * INIT_BLOCK_ROWS);
+        int64_t end = cell_index(0, row_end);
         
-        OpticalMaterial old_mat = materials[world[pos_x][pos_y].material_id];
-        OpticalMaterial new_mat = materials[world[new_x][new_y].material_id];
+        // Teplota má iba 100 úrovní - súčty akumulátorov z histogramu
+        // úrovní namiesto logaritmu v každej bunke
+        int64_t level_count[INITIAL_TEMPERATURE_LEVELS] = {0};
         
-        if (old_mat.refractive_index != new_mat.refractive_index) {
-            float incident_angle = fabs(current_direction);
-            float refraction_angle = snell_law(
-                old_mat.refractive_index,
-                new_mat.refractive_index,
-                incident_angle
-            );
-            
-            if (refraction_angle >= 0) {
-                photon.refractions++;
-                current_direction = refraction_angle;
+        for (int64_t idx = begin; idx < end; idx++) {
+            int material, level;
+            if (sim->world_image.material) {
+                material = sim->world_image.material[idx];
+                level = sim->world_image.level[idx];
             } else {
-                photon.reflections++;
-                current_direction = -current_direction;
+                uint64_t hash = cell_hash(idx);
+                material = cell_initial_material(hash);
+                level = cell_initial_temperature_level(hash);
             }
+            sim->world.photon_visits[idx] = 0;
+            sim->world.energy_density[idx] = 0.0;
+            sim->world.temperature[idx] = initial_temperature(level);
+            sim->world.accumulated_phase[idx] = 0.0;
+            sim->world.interference_pattern[idx] = 0.0;
+            sim->world.material_id[idx] = material;
+            sim->world.boundary_distance[idx] = 0;
+            level_count[level]++;
         }
         
-        pos_x = new_x;
-        pos_y = new_y;
-        
-        float step_length = optical_distance(pos_x - dx[direction], 
-                                            pos_y - dy[direction], 
-                                            pos_x, pos_y);
-        photon.optical_path_length += step_length;
-        metrics.total_optical_path += step_length;
-        
-        photon.phase += (2 * M_PI / photon.wavelength) * 
-                       new_mat.refractive_index * (CELL_SIZE / new_mat.refractive_index);
-        photon.accumulated_phase = fmod(photon.phase, 2*M_PI);
-        
-        photon.group_velocity = SPEED_OF_LIGHT / new_mat.refractive_index;
-        
-        if (photon.optical_path_length / CELL_SIZE - last_print >= 1000) {
-            float info_entropy = calculate_information_entropy();
-            float therm_entropy = calculate_thermal_entropy();
-            float quantum_entropy = calculate_quantum_entropy();
-            
-            printf("Dráha %6.0fµm: [%"PRId32",%"PRId32"] %s\n", 
-                   photon.optical_path_length * 1e6, pos_x, pos_y,
-                   materials[world[pos_x][pos_y].material_id].name);
-            printf("         Intenzita: %.3f | Teplota: %.1fK\n",
-                   photon.intensity, world[pos_x][pos_y].temperature);
-            printf("         Odrazy: %"PRId32" | Lomy: %"PRId32"\n",
-                   photon.reflections, photon.refractions);
-            printf("         Entropia: S_info=%.3f, S_therm=%.3f, S_quant=%.3f\n",
-                   info_entropy, therm_entropy, quantum_entropy);
-            
-            last_print = photon.optical_path_length / CELL_SIZE;
-        }
-        
-        if (world[pos_x][pos_y].is_target == 1) {
-            printf("\n╔══════════════════════════════════════════════════╗\n");
-            printf("║   [DOMOV NÁJDENÝ] na dráhe %.1f µm!            ║\n", 
-                   photon.optical_path_length * 1e6);
-            printf("║   Zostatková intenzita: %.3f                   ║\n", photon.intensity);
-            printf("╚══════════════════════════════════════════════════╝\n");
-            
-            target_x = dimension - 1;
-            target_y = dimension - 1;
-        }
-        
-        if (world[pos_x][pos_y].is_target == 2) {
-            printf("\n╔══════════════════════════════════════════════════╗\n");
-            printf("║   [BAR NÁJDENÝ] na dráhe %.1f µm!              ║\n", 
-                   photon.optical_path_length * 1e6);
-            printf("║   Celková optická dráha: %.1f µm              ║\n", 
-                   metrics.total_optical_path * 1e6);
-            printf("╚══════════════════════════════════════════════════╝\n");
-            break;
+        for (int level = 0; level < INITIAL_TEMPERATURE_LEVELS; level++) {
+            float temperature = initial_temperature(level);
+            w->block_acc[b].total_temperature += level_count[level] * (double)temperature;
+            w->block_acc[b].temperature_log_sum += level_count[level] * xlogx(temperature);
         }
     }
     
-    calculate_information_entropy();
-    calculate_thermal_entropy();
-    calculate_quantum_entropy();
+    return NULL;
+}
+
+void init_optical_world(int32_t dim, const char *dir) {
+    sim->dimension = dim;
+    memset(&sim->entropy_acc, 0, sizeof(sim->entropy_acc));
+    
+    // Jedna aréna pre všetky polia, každé pole zarovnané na 64 B
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    size_t aligned_cells = ((size_t)cells + 63) & ~(size_t)63;
+    char *base = (char*)arena_reserve(&sim->world_arena, aligned_cells * WORLD_BYTES_PER_CELL);
+    if (!base) {
+        printf("Chyba: Nedostatok pamäte pre svet %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
+        exit(1);
+    }
+
+    sim->world.photon_visits = (int32_t*)base;
+    sim->world.temperature = (float*)(base + aligned_cells * 4);
+    sim->world.energy_density = (float*)(base + aligned_cells * 8);
+    sim->world.accumulated_phase = (float*)(base + aligned_cells * 12);
+    sim->world.interference_pattern = (float*)(base + aligned_cells * 16);
+    sim->world.material_id = (uint8_t*)(base + aligned_cells * 20);
+    sim->world.boundary_distance = (uint8_t*)(base + aligned_cells * 21);
     
-    int64_t visited = 0;
-    for (int32_t x = 0; x < dimension; x++) {
-        for (int32_t y = 0; y < dimension; y++) {
-            if (world[x][y].photon_visits > 0) visited++;
+    // Fyzikálne korektná inicializácia
+    if (!sim->quiet) {
+        printf("Inicializujem optický svet %"PRId32"x%"PRId32" (%"PRId64" buniek, %"PRId32" vlákien)...\n", 
+               sim->dimension, sim->dimension, cells, sim->world_init_threads);
+    }
+    if (dir) {
+        world_image_open(&sim->world_image, dir, sim->dimension, sim->world.seed);
+        if (!sim->quiet) {
+            printf("  • Zdieľaný svet: %s (%s)\n", sim->world_image.path,
+                   sim->world_image.generated ? "vygenerovaný" : "namapovaný");
         }
     }
-    metrics.visited_cells = visited;
-    metrics.coverage = (float)visited / metrics.total_cells * 100.0;
     
-    if (photon.optical_path_length / CELL_SIZE + 1 > 0) {
-        metrics.average_intensity = cumulative_intensity / (photon.optical_path_length / CELL_SIZE + 1);
-    } else {
-        metrics.average_intensity = 0.0;
+    // Bloky riadkov majú pevnú veľkosť a ich súčty sa sčítajú v poradí
+    // blokov, takže ani akumulátory nezávisia od počtu vlákien
+    int32_t blocks = (sim->dimension + INIT_BLOCK_ROWS - 1) / INIT_BLOCK_ROWS;
+    int32_t threads = sim->world_init_threads < blocks ? sim->world_init_threads : blocks;
+    EntropyAccumulator *block_acc = (EntropyAccumulator*)calloc(blocks, sizeof(EntropyAccumulator));
+    WorldInitWorker *workers = (WorldInitWorker*)calloc(threads, sizeof(WorldInitWorker));
+    if (!block_acc || !workers) {
+        printf("Chyba: Nedostatok pamäte pre inicializáciu sveta\n");
+        exit(1);
     }
     
-    if (metrics.total_energy_absorbed > 0) {
-        metrics.photon_efficiency = photon.optical_path_length / metrics.total_energy_absorbed;
-    } else {
-        metrics.photon_efficiency = 0.0;
+    for (int32_t t = 0; t < threads; t++) {
+        workers[t].first_block = t;
+        workers[t].block_stride = threads;
+        workers[t].block_acc = block_acc;
+        simulation_thread_create(&workers[t].thread, world_init_worker, &workers[t]);
+    }
+    for (int32_t t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    
+    for (int32_t b = 0; b < blocks; b++) {
+        sim->entropy_acc.total_visits += block_acc[b].total_visits;
+        sim->entropy_acc.visit_log_sum += block_acc[b].visit_log_sum;
+        sim->entropy_acc.total_temperature += block_acc[b].total_temperature;
+        sim->entropy_acc.temperature_log_sum += block_acc[b].temperature_log_sum;
+        sim->entropy_acc.visited_cells += block_acc[b].visited_cells;
     }
+    free(block_acc);
+    free(workers);
+    world_image_close(&sim->world_image);
+    
+    // Ciele s fyzikálnou interpretáciou
+    sim->world.home_cell = cell_index(0, 0);
+    sim->world.material_id[sim->world.home_cell] = 2;
+    
+    sim->world.bar_cell = cell_index(sim->dimension-1, sim->dimension-1);
+    sim->world.material_id[sim->world.bar_cell] = 1;
 }
 
-/* ==================== HLAVNÝ PROGRAM ==================== */
+void init_photon(Photon *p) {
+    p->wavelength = WAVELENGTH;
+    p->intensity = 1.0;
+    p->phase = 0.0;
+    p->polarization[0] = 1.0;
+    p->polarization[1] = 0.0;
+    p->coherence_length = 1.0e-3;
+    p->optical_path_length = 0.0;
+    p->reflections = 0;
+    p->refractions = 0;
+    p->accumulated_phase = 0.0;
+    p->group_velocity = SPEED_OF_LIGHT / materials[cell_material(sim->start_x, sim->start_y)].refractive_index;
+}
 
-int main() {
-    srand(time(NULL));
-    
-    printf("╔══════════════════════════════════════════════════════════════╗\n");
-    printf("║          KYBERNAUT-LIGHT v3.1 - OPTICKÁ VERZIA             ║\n");
-    printf("║      (Fyzikálne korektná simulácia fotónu)                ║\n");
-    printf("║                PODPORA PRE VEĽKÉ MRIEŽKY                  ║\n");
-    printf("╚══════════════════════════════════════════════════════════════╝\n\n");
+/* Fotón v štartovej bunke s daným smerom emisie */
+void init_photon_state(PhotonState *ps, float direction) {
+    init_photon(&ps->photon);
+    ps->pos_x = sim->start_x;
+    ps->pos_y = sim->start_y;
+    ps->target_x = sim->target_x;
+    ps->target_y = sim->target_y;
+    ps->current_direction = direction;
+    ps->direction_state = DIRECTION_FREE;
+    ps->uniform_run = 0;
+}
+
+void init_metrics() {
+    sim->metrics.information_entropy = 0.0;
+    sim->metrics.thermal_entropy = 0.0;
+    sim->metrics.quantum_entropy = 0.0;
     
-    printf("OPTICKÁ KOREKTNOSŤ:\n");
-    printf("  • Snellov zákon a Fresnelove koeficienty\n");
-    printf("  • Beer-Lambertov zákon absorpcie\n");
-    printf("  • Projekcia 3D optiky do 2D\n");
-    printf("  • Interferenčné a fázové efekty\n\n");
+    sim->metrics.total_optical_path = 0.0;
+    sim->metrics.average_intensity = 0.0;
+    sim->metrics.photon_efficiency = 0.0;
     
-    printf("Zadaj rozmer sveta (napr. 15-1000): ");
-    if (scanf("%"SCNd32, &dimension) != 1 || dimension < 5) {
-        printf("Chyba: Neplatný rozmer.\n");
-        return 1;
-    }
+    sim->metrics.total_energy_absorbed = 0.0;
+    sim->metrics.max_temperature = 0.0;
+    sim->metrics.min_temperature = 1000.0;
     
-    if (dimension > 1000) {
+    sim->metrics.total_cells = (int64_t)sim->dimension * sim->dimension;
+    sim->metrics.visited_cells = 0;
+    sim->metrics.coverage = 0.0;
+}
+
+/* ==================== PROPAGÁCIA FOTÓNU ==================== */
+
+/* Depozícia v aktuálnej bunke: vráti absorbovanú intenzitu
+ * a zoslabí fotón podľa Beer-Lambertovho zákona */
+float photon_deposit(Photon *p, int material_id) {
+    OpticalMaterial mat = materials[material_id];
+    float absorbed = p->intensity * mat.absorption_coeff * CELL_SIZE;
+    
+    p->intensity = beer_lambert_absorption(
+        p->intensity, 
+        mat.extinction_coeff, 
+        CELL_SIZE
+    );
+    
+    return absorbed;
+}
+
+/* Prírastok optickej dráhy a fázy pri vstupe do bunky materiálu material_id */
+static inline void photon_advance(Photon *p, float step_length, int material_id) {
+    OpticalMaterial mat = materials[material_id];
+    
+    p->optical_path_length += step_length;
+    p->phase += (2 * M_PI / p->wavelength) * 
+                mat.refractive_index * (CELL_SIZE / mat.refractive_index);
+}
+
+/* Presun fotónu do susednej bunky: rozhodnutie, lom/odraz, dráha a fáza.
+ * Vráti 0, ak fotón nemá kam pokračovať. */
+int photon_move(PhotonState *ps) {
+    Photon *p = &ps->photon;
+    
+    if (ps->uniform_run > 0) {
+        // Vnútri homogénnej oblasti sa smer, stav ani dĺžka kroku nemenia
+        ps->uniform_run--;
+        ps->pos_x += direction_dx[ps->direction_state];
+        ps->pos_y += direction_dy[ps->direction_state];
+        photon_advance(p, ps->uniform_step, cell_material(ps->pos_x, ps->pos_y));
+        p->accumulated_phase = fmod(p->phase, 2*M_PI);
+        return 1;
+    }
+    
+    int32_t old_state = ps->direction_state;
+    int32_t direction;
+    if (transition_tables_enabled && ps->direction_state != DIRECTION_FREE) {
+        direction = table_transition_decision(ps->pos_x, ps->pos_y, ps->direction_state,
+                                              ps->target_x, ps->target_y);
+    } else {
+        direction = optical_transition_decision(ps->pos_x, ps->pos_y, 
+                                                ps->current_direction,
+                                                ps->target_x, ps->target_y);
+    }
+    
+    if (direction == -1) {
+        return 0;
+    }
+    
+    int32_t new_x = ps->pos_x + direction_dx[direction];
+    int32_t new_y = ps->pos_y + direction_dy[direction];
+    ps->current_direction = direction_angles[direction];
+    
+    if (new_x < 0 || new_x >= sim->dimension || new_y < 0 || new_y >= sim->dimension) {
+        return 0;
+    }
+    
+    int old_material = cell_material(ps->pos_x, ps->pos_y);
+    int new_material = cell_material(new_x, new_y);
+    OpticalMaterial old_mat = materials[old_material];
+    OpticalMaterial new_mat = materials[new_material];
+    
+    if (transition_tables_enabled) {
+        // Nový stav smeru z tabuľky; stavy 8-15 sú odrazy, od 16 lomy
+        int32_t state = transition_tables.next_state[old_material][new_material][direction];
+        if (state >= 16) {
+            p->refractions++;
+        } else if (state >= 8) {
+            p->reflections++;
+        }
+        ps->direction_state = state;
+        ps->current_direction = transition_tables.state_angle[state];
+    } else if (old_mat.refractive_index != new_mat.refractive_index) {
+        float incident_angle = fabs(ps->current_direction);
+        float refraction_angle = snell_law(
+            old_mat.refractive_index,
+            new_mat.refractive_index,
+            incident_angle
+        );
+        
+        if (refraction_angle >= 0) {
+            p->refractions++;
+            ps->current_direction = refraction_angle;
+        } else {
+            p->reflections++;
+            ps->current_direction = -ps->current_direction;
+        }
+    }
+    
+    float step_length = optical_distance(ps->pos_x, ps->pos_y, new_x, new_y);
+    if (sim->empty_space_skip_enabled && transition_tables_enabled && old_state == direction) {
+        ps->uniform_run = uniform_run_length(ps, direction);
+        ps->uniform_step = step_length;
+    }
+    ps->pos_x = new_x;
+    ps->pos_y = new_y;
+    photon_advance(p, step_length, new_material);
+    p->accumulated_phase = fmod(p->phase, 2*M_PI);
+    
+    p->group_velocity = SPEED_OF_LIGHT / new_mat.refractive_index;
+    
+    return 1;
+}
+
+/* Kontrola cieľa v aktuálnej bunke: po domove sa fotón nasmeruje na bar.
+ * Vráti is_target bunky (0, 1 = domov, 2 = bar). */
+int photon_check_target(PhotonState *ps) {
+    int is_target = cell_target(ps->pos_x, ps->pos_y);
+    
+    if (is_target == 1) {
+        ps->target_x = sim->dimension - 1;
+        ps->target_y = sim->dimension - 1;
+        ps->uniform_run = 0;
+    }
+    
+    return is_target;
+}
+
+/* ==================== DETEKCIA CYKLOV ==================== */
+
+/* Ďalší krok fotónu závisí iba od (poloha, smer, cieľ). Keď sa tento stav
+ * zopakuje, fotón je uväznený v slučke a zvyšok behu sa dá prehrať
+ * zo zaznamenaného cyklu bez rozhodovania o smere. Cyklus hľadá Brentov
+ * algoritmus (jeden uložený stav, porovnanie v každom kroku). */
+#define CYCLE_MAX_LENGTH 1024
+
+typedef struct {
+    int32_t pos_x, pos_y;
+    int32_t target_x, target_y;
+    float direction;
+} TrajectoryKey;
+
+/* Jeden krok zaznamenaného cyklu */
+typedef struct {
+    int64_t cell;                 // Bunka depozície (pred presunom)
+    int32_t pos_x, pos_y;         // Poloha po presune
+    float direction;              // Smer po presune
+    int32_t direction_state;
+    float step_length;            // Prírastok optickej dráhy [m]
+    uint8_t material;             // Materiál bunky depozície
+    uint8_t new_material;         // Materiál bunky po presune
+    int8_t reflection, refraction;
+    int8_t is_target;             // Cieľ v bunke po presune
+    int8_t first_visit;           // Prvý výskyt bunky depozície v cykle
+} CycleStep;
+
+typedef struct {
+    int active;                   // 0 = detekcia vypnutá
+    TrajectoryKey saved;          // Brent: uložený stav
+    int64_t power, lambda;
+    int64_t length;               // Dĺžka nájdeného cyklu (0 = nenájdený)
+    int64_t recorded;             // Počet zaznamenaných krokov cyklu
+    PhotonState prev;             // Stav pred posledným krokom
+    CycleStep steps[CYCLE_MAX_LENGTH];
+} CycleTracker;
+
+int cycle_detection_enabled = 1;  // --no-cycles: bez rýchleho posunu
+
+static inline TrajectoryKey trajectory_key(const PhotonState *ps) {
+    TrajectoryKey key = {ps->pos_x, ps->pos_y, ps->target_x, ps->target_y, ps->current_direction};
+    return key;
+}
+
+static inline int trajectory_key_equal(TrajectoryKey a, TrajectoryKey b) {
+    return a.pos_x == b.pos_x && a.pos_y == b.pos_y &&
+           a.target_x == b.target_x && a.target_y == b.target_y &&
+           a.direction == b.direction;
+}
+
+/* Jeden krok Brentovho algoritmu; vráti dĺžku cyklu alebo 0 */
+static inline int64_t brent_step(TrajectoryKey *saved, int64_t *power, int64_t *lambda,
+                                 TrajectoryKey key) {
+    (*lambda)++;
+    
+    if (trajectory_key_equal(key, *saved)) {
+        return *lambda;
+    }
+    
+    if (*power == *lambda) {
+        // Perióda dlhšia ako záznam - detekcia začne odznova od tohto stavu
+        *power = (*power >= CYCLE_MAX_LENGTH) ? 1 : *power * 2;
+        *saved = key;
+        *lambda = 0;
+    }
+    
+    return 0;
+}
+
+void cycle_tracker_init(CycleTracker *ct, const PhotonState *ps) {
+    ct->active = cycle_detection_enabled;
+    ct->saved = trajectory_key(ps);
+    ct->power = 1;
+    ct->lambda = 0;
+    ct->length = 0;
+    ct->recorded = 0;
+    ct->prev = *ps;
+}
+
+/* Volá sa po každom úplnom kroku (depozícia, presun, kontrola cieľa).
+ * Vráti 1, keď je zaznamenaný celý cyklus a možno prejsť na prehrávanie. */
+int cycle_tracker_step(CycleTracker *ct, const PhotonState *ps, int is_target) {
+    if (!ct->active) return 0;
+    
+    if (ct->length > 0) {
+        // Záznam jednej periódy po nájdení cyklu
+        CycleStep *step = &ct->steps[ct->recorded];
+        step->cell = cell_index(ct->prev.pos_x, ct->prev.pos_y);
+        step->pos_x = ps->pos_x;
+        step->pos_y = ps->pos_y;
+        step->direction = ps->current_direction;
+        step->direction_state = ps->direction_state;
+        step->step_length = optical_distance(ct->prev.pos_x, ct->prev.pos_y, ps->pos_x, ps->pos_y);
+        step->material = cell_material(ct->prev.pos_x, ct->prev.pos_y);
+        step->new_material = cell_material(ps->pos_x, ps->pos_y);
+        step->reflection = ps->photon.reflections - ct->prev.photon.reflections;
+        step->refraction = ps->photon.refractions - ct->prev.photon.refractions;
+        step->is_target = is_target;
+        step->first_visit = 1;
+        for (int64_t i = 0; i < ct->recorded; i++) {
+            if (ct->steps[i].cell == step->cell) {
+                step->first_visit = 0;
+                break;
+            }
+        }
+        
+        ct->prev = *ps;
+        return ++ct->recorded == ct->length;
+    }
+    
+    ct->prev = *ps;
+    ct->length = brent_step(&ct->saved, &ct->power, &ct->lambda, trajectory_key(ps));
+    return 0;
+}
+
+/* Krok zaznamenaného cyklu: presun, počítadlá a dráha ako v photon_move */
+static inline void cycle_step_apply(PhotonState *ps, const CycleStep *step) {
+    ps->pos_x = step->pos_x;
+    ps->pos_y = step->pos_y;
+    ps->current_direction = step->direction;
+    ps->direction_state = step->direction_state;
+    ps->photon.reflections += step->reflection;
+    ps->photon.refractions += step->refraction;
+    photon_advance(&ps->photon, step->step_length, step->new_material);
+}
+
+/* Odvodené veličiny fotónu, ktoré prehrávanie počíta iba raz na konci */
+void cycle_finish_photon(PhotonState *ps) {
+    OpticalMaterial mat = materials[cell_material(ps->pos_x, ps->pos_y)];
+    ps->photon.accumulated_phase = fmod(ps->photon.phase, 2*M_PI);
+    ps->photon.group_velocity = SPEED_OF_LIGHT / mat.refractive_index;
+}
+
+/* ==================== HLAVNÁ OPTICKÁ SIMULÁCIA ==================== */
+
+/* Priebežný výpis jedného fotónu (každých 1000 µm dráhy) */
+void print_propagation_progress(const PhotonState *ps) {
+    if (sim->quiet) return;
+    
+    float info_entropy = calculate_information_entropy();
+    float therm_entropy = calculate_thermal_entropy();
+    float quantum_entropy = calculate_quantum_entropy(&ps->photon);
+#ifdef DEBUG
+    entropy_cross_check("priebeh");
+#endif
+    
+    printf("Dráha %6.0fµm: [%"PRId32",%"PRId32"] %s\n", 
+           ps->photon.optical_path_length * 1e6, ps->pos_x, ps->pos_y,
+           materials[cell_material(ps->pos_x, ps->pos_y)].name);
+    printf("         Intenzita: %.3f | Teplota: %.1fK\n",
+           ps->photon.intensity, *world_cell(cell_index(ps->pos_x, ps->pos_y)).temperature);
+    printf("         Odrazy: %"PRId32" | Lomy: %"PRId32"\n",
+           ps->photon.reflections, ps->photon.refractions);
+    printf("         Entropia: S_info=%.3f, S_therm=%.3f, S_quant=%.3f\n",
+           info_entropy, therm_entropy, quantum_entropy);
+}
+
+void print_home_found(const PhotonState *ps) {
+    if (sim->quiet) return;
+    printf("\n╔══════════════════════════════════════════════════╗\n");
+    printf("║   [DOMOV NÁJDENÝ] na dráhe %.1f µm!            ║\n", 
+           ps->photon.optical_path_length * 1e6);
+    printf("║   Zostatková intenzita: %.3f                   ║\n", ps->photon.intensity);
+    printf("╚══════════════════════════════════════════════════╝\n");
+}
+
+/* Súčty entropických akumulátorov pre bunky cyklu - pri prehrávaní sa
+ * zapisujú iba polia sveta a akumulátory sa dorovnajú naraz */
+typedef struct {
+    int32_t visits[CYCLE_MAX_LENGTH];
+    float temperature[CYCLE_MAX_LENGTH];
+} CycleFlush;
+
+void cycle_flush_snapshot(const CycleTracker *ct, CycleFlush *f) {
+    for (int64_t i = 0; i < ct->length; i++) {
+        if (!ct->steps[i].first_visit) continue;
+        CellRef c = world_cell(ct->steps[i].cell);
+        f->visits[i] = *c.photon_visits;
+        f->temperature[i] = *c.temperature;
+    }
+}
+
+void cycle_flush_accumulators(const CycleTracker *ct, CycleFlush *f) {
+    for (int64_t i = 0; i < ct->length; i++) {
+        if (!ct->steps[i].first_visit) continue;
+        CellRef c = world_cell(ct->steps[i].cell);
+        int32_t visits = *c.photon_visits;
+        float temperature = *c.temperature;
+        
+        sim->entropy_acc.total_visits += visits - f->visits[i];
+        sim->entropy_acc.visit_log_sum += xlogx(visits) - xlogx(f->visits[i]);
+        entropy_acc_temperature(f->temperature[i], temperature);
+        
+        f->visits[i] = visits;
+        f->temperature[i] = temperature;
+    }
+}
+
+/* Rozbehnuté prehrávanie cyklu; rozhranie knižnice ho delí na úseky */
+typedef struct {
+    int active;                   // Prehráva sa zaznamenaný cyklus
+    int64_t index;                // Nasledujúci krok cyklu
+    CycleFlush flush;
+} CycleReplay;
+
+void fast_forward_begin(CycleReplay *replay, const CycleTracker *ct) {
+    cycle_flush_snapshot(ct, &replay->flush);
+    replay->index = 0;
+    replay->active = 1;
+}
+
+/* Rýchly posun uväzneného fotónu: zaznamenaný cyklus sa prehráva krok po
+ * kroku s rovnakou aritmetikou ako hlavná slučka (dráha, útlm, depozícia),
+ * ale bez rozhodovania o smere, logaritmov a kosínusov. Výsledky sú preto
+ * zhodné s úplnou simuláciou až po posledný bit. Prehrá najviac max_steps
+ * krokov a vráti ich počet; keď fotón skončí, dorovná akumulátory
+ * a prehrávanie ukončí. */
+int64_t fast_forward_photon(PhotonState *ps, const CycleTracker *ct, CycleReplay *replay,
+                            int32_t *last_print, int64_t max_steps) {
+    CycleFlush *flush = &replay->flush;
+    int64_t i = replay->index;
+    int64_t done = 0;
+    while (ps->photon.optical_path_length < MAX_STEPS * CELL_SIZE && 
+           ps->photon.intensity > 1e-6) {
+        if (done == max_steps) {
+            replay->index = i;
+            return done;
+        }
+        
+        const CycleStep *step = &ct->steps[i];
+        CellRef c = world_cell(step->cell);
+        
+        (*c.photon_visits)++;
+        *c.accumulated_phase += ps->photon.phase;
+        
+        float absorbed = photon_deposit(&ps->photon, step->material);
+        *c.energy_density += absorbed;
+        float temperature = *c.temperature + absorbed * 100.0;
+        *c.temperature = temperature;
+        sim->metrics.total_energy_absorbed += absorbed * PHOTON_ENERGY;
+        
+        if (temperature > sim->metrics.max_temperature) {
+            sim->metrics.max_temperature = temperature;
+        }
+        if (temperature < sim->metrics.min_temperature) {
+            sim->metrics.min_temperature = temperature;
+        }
+        
+        cycle_step_apply(ps, step);
+        
+        if (ps->photon.optical_path_length / CELL_SIZE - *last_print >= 1000) {
+            cycle_flush_accumulators(ct, flush);
+            print_propagation_progress(ps);
+            *last_print = ps->photon.optical_path_length / CELL_SIZE;
+        }
+        
+        // Bar v cykle byť nemôže (beh by skončil), domov áno
+        if (step->is_target == 1) {
+            print_home_found(ps);
+        }
+        
+        if (++i == ct->length) i = 0;
+        done++;
+    }
+    
+    cycle_flush_accumulators(ct, flush);
+    for (int64_t k = 0; k < ct->length; k++) {
+        CellRef c = world_cell(ct->steps[k].cell);
+        *c.interference_pattern = 0.5 + 0.5 * cos(*c.accumulated_phase);
+    }
+    
+    cycle_finish_photon(ps);
+    replay->active = 0;
+    return done;
+}
+
+/* Rozbehnutý jednofotónový beh. Slučka simulácie je rozdelená na začiatok,
+ * krok a koniec, takže ju okrem simulate_photon_propagation môže po
+ * častiach krokovať aj rozhranie knižnice. */
+typedef struct {
+    PhotonState ps;
+    CycleTracker cycle;
+    CycleReplay replay;
+    int32_t last_print;
+    float cumulative_intensity;
+    int64_t steps;                // Vykonané kroky fotónu vrátane prehratých z cyklu
+    int finished;                 // Fotón skončil a metriky sú záverečné
+} PropagationRun;
+
+void propagation_begin(PropagationRun *run) {
+    PhotonState *ps = &run->ps;
+    init_photon_state(ps, atan2(sim->target_y - sim->start_y, sim->target_x - sim->start_x));
+    
+    if (!sim->quiet) {
+        printf("\n[KYBERNAUT-LIGHT v3.1] Fyzikálne korektná optická simulácia\n");
+        printf("==============================================================\n");
+        printf("Optické parametre:\n");
+        printf("  • Vlnová dĺžka: %.1f nm\n", WAVELENGTH * 1e9);
+        printf("  • Bunka: %.1f µm\n", CELL_SIZE * 1e6);
+        printf("  • Časový krok: %.1f fs\n", TIME_STEP * 1e15);
+        printf("  • Energie fotónu: %.3e J\n", PHOTON_ENERGY);
+        printf("  • Rozmer sveta: %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
+        printf("==============================================================\n");
+    }
+    
+    run->last_print = 0;
+    run->cumulative_intensity = ps->photon.intensity;
+    run->steps = 0;
+    run->finished = 0;
+    run->replay.active = 0;
+    cycle_tracker_init(&run->cycle, ps);
+}
+
+/* Jeden krok fotónu, počas rýchleho posunu najviac max_steps prehratých
+ * krokov; vráti ich počet, 0 = beh skončil (dráha, útlm, okraj alebo bar) */
+int64_t propagation_step(PropagationRun *run, int64_t max_steps) {
+    PhotonState *ps = &run->ps;
+    if (run->replay.active) {
+        int64_t replayed = fast_forward_photon(ps, &run->cycle, &run->replay,
+                                               &run->last_print, max_steps);
+        run->steps += replayed;
+        return replayed;
+    }
+    if (!(ps->photon.optical_path_length < MAX_STEPS * CELL_SIZE && 
+          ps->photon.intensity > 1e-6)) {
+        return 0;
+    }
+    run->steps++;
+    
+    CellRef c = world_cell(cell_index(ps->pos_x, ps->pos_y));
+    
+    entropy_acc_visit(*c.photon_visits);
+    (*c.photon_visits)++;
+    
+    *c.accumulated_phase += ps->photon.phase;
+    *c.interference_pattern = 
+        0.5 + 0.5 * cos(*c.accumulated_phase);
+    
+    float absorbed = photon_deposit(&ps->photon, cell_material(ps->pos_x, ps->pos_y));
+    *c.energy_density += absorbed;
+    float old_temperature = *c.temperature;
+    float temperature = old_temperature + absorbed * 100.0;
+    *c.temperature = temperature;
+    entropy_acc_temperature(old_temperature, temperature);
+    sim->metrics.total_energy_absorbed += absorbed * PHOTON_ENERGY;
+    
+    if (temperature > sim->metrics.max_temperature) {
+        sim->metrics.max_temperature = temperature;
+    }
+    if (temperature < sim->metrics.min_temperature) {
+        sim->metrics.min_temperature = temperature;
+    }
+    
+    if (!photon_move(ps)) {
+        return 0;
+    }
+    
+    if (ps->photon.optical_path_length / CELL_SIZE - run->last_print >= 1000) {
+        print_propagation_progress(ps);
+        run->last_print = ps->photon.optical_path_length / CELL_SIZE;
+    }
+    
+    int is_target = photon_check_target(ps);
+    
+    if (is_target == 1) {
+        print_home_found(ps);
+    }
+    
+    if (is_target == 2) {
+        if (!sim->quiet) {
+            printf("\n╔══════════════════════════════════════════════════╗\n");
+            printf("║   [BAR NÁJDENÝ] na dráhe %.1f µm!              ║\n", 
+                   ps->photon.optical_path_length * 1e6);
+            printf("║   Celková optická dráha: %.1f µm              ║\n", 
+                   ps->photon.optical_path_length * 1e6);
+            printf("╚══════════════════════════════════════════════════╝\n");
+        }
+        return 0;
+    }
+    
+    if (cycle_tracker_step(&run->cycle, ps, is_target)) {
+        fast_forward_begin(&run->replay, &run->cycle);
+    }
+    return 1;
+}
+
+/* Záverečné metriky z aktuálneho stavu fotónu; stav behu nemení, takže
+ * rozhranie knižnice ju volá aj na priebežné metriky */
+void propagation_finish(PropagationRun *run) {
+    sim->photon = run->ps.photon;
+    sim->metrics.total_optical_path = sim->photon.optical_path_length;
+    
+    calculate_information_entropy();
+    calculate_thermal_entropy();
+    calculate_quantum_entropy(&sim->photon);
+#ifdef DEBUG
+    entropy_cross_check("koniec");
+#endif
+    
+    sim->metrics.visited_cells = sim->entropy_acc.visited_cells;
+    sim->metrics.coverage = (float)sim->metrics.visited_cells / sim->metrics.total_cells * 100.0;
+    
+    if (sim->photon.optical_path_length / CELL_SIZE + 1 > 0) {
+        sim->metrics.average_intensity = run->cumulative_intensity / (sim->photon.optical_path_length / CELL_SIZE + 1);
+    } else {
+        sim->metrics.average_intensity = 0.0;
+    }
+    
+    if (sim->metrics.total_energy_absorbed > 0) {
+        sim->metrics.photon_efficiency = sim->photon.optical_path_length / sim->metrics.total_energy_absorbed;
+    } else {
+        sim->metrics.photon_efficiency = 0.0;
+    }
+}
+
+void simulate_photon_propagation() {
+    PropagationRun run;           // CycleTracker drží celú periódu cyklu
+    propagation_begin(&run);
+    while (propagation_step(&run, INT64_MAX)) {
+    }
+    propagation_finish(&run);
+    run.finished = 1;
+}
+
+/* ==================== ENSEMBLE FOTÓNOV (MULTI-CORE) ==================== */
+
+/* Privátne polia vlákna ensemblu po dlaždiciach súvislých indexov buniek.
+ * Dlaždica vznikne až pri prvej depozícii do nej, pamäť vlákna teda rastie
+ * s plochou, ktorú jeho fotóny prešli, nie s plochou sveta. */
+#define ENSEMBLE_TILE_BITS 10
+#define ENSEMBLE_TILE_CELLS (1 << ENSEMBLE_TILE_BITS)
+
+typedef struct {
+    int32_t visits[ENSEMBLE_TILE_CELLS];  // Návštevy fotónov tohto vlákna
+    float energy[ENSEMBLE_TILE_CELLS];    // Absorbovaná intenzita
+    float heat[ENSEMBLE_TILE_CELLS];      // Prírastok teploty [K]
+} EnsembleTile;                           // 12 KB
+
+/* Vlákno ensemblu: riedke privátne polia + súhrny za jeho fotóny.
+ * Počas trasovania sa svet iba číta, takže vlákna sa nesynchronizujú. */
+typedef struct EnsembleWorker {
+    pthread_t thread;
+    EnsembleTile **tiles;         // Dlaždice podľa indexu, NULL = nedotknutá
+    int64_t tile_count;           // Alokované dlaždice
+    
+    double path_sum;              // Σ optická dráha [m]
+    double intensity_sum;         // Σ konečná intenzita
+    double average_intensity_sum; // Σ priemerná intenzita fotónu
+    double energy_sum;            // Σ absorbovaná energia [J]
+    double group_velocity_sum;    // Σ skupinová rýchlosť [m/s]
+    int64_t reflections_sum;
+    int64_t refractions_sum;
+    int64_t steps;                // Počet krokov všetkých fotónov
+    int64_t photons;              // Počet spracovaných fotónov
+    int64_t next_photon;          // Aktuálny blok pridelených fotónov
+    int64_t end_photon;
+    CycleTracker *cycle;          // Detekcia cyklov trasovaného fotónu
+} EnsembleWorker;
+
+/* Zlučovacie vlákno: dlaždice [tile_begin, tile_end) + prírastky súčtov */
+typedef struct {
+    pthread_t thread;
+    int64_t tile_begin, tile_end;
+    EntropyAccumulator acc;
+    float max_temperature;
+    float min_temperature;
+} EnsembleMerge;
+
+EnsembleTile *ensemble_tile_alloc(EnsembleWorker *w, int64_t tile) {
+    EnsembleTile *t = (EnsembleTile*)calloc(1, sizeof(EnsembleTile));
+    if (!t) {
+        printf("Chyba: Nedostatok pamäte pre privátne polia ensemblu\n");
+        exit(1);
+    }
+    w->tiles[tile] = t;
+    w->tile_count++;
+    return t;
+}
+
+/* Depozícia fotónu do privátnej dlaždice vlákna */
+KERNEL_INLINE void ensemble_deposit(EnsembleWorker *w, int64_t idx, float absorbed) {
+    EnsembleTile *t = w->tiles[idx >> ENSEMBLE_TILE_BITS];
+    if (__builtin_expect(t == NULL, 0)) t = ensemble_tile_alloc(w, idx >> ENSEMBLE_TILE_BITS);
+    int64_t i = idx & (ENSEMBLE_TILE_CELLS - 1);
+    
+    t->visits[i]++;
+    t->energy[i] += absorbed;
+    t->heat[i] += absorbed * 100.0;
+    w->energy_sum += absorbed * PHOTON_ENERGY;
+    w->steps++;
+}
+
+/* Pridelenie ďalšieho fotónu vláknu - bloky z atomického čítača, bez zámkov.
+ * Vráti -1, keď sú všetky fotóny rozdané. */
+int64_t ensemble_claim_photon(EnsembleWorker *w) {
+    if (w->next_photon >= w->end_photon) {
+        int64_t first = __atomic_fetch_add(&sim->ensemble_next_photon, ENSEMBLE_CHUNK, __ATOMIC_RELAXED);
+        if (first >= ensemble_photons) return -1;
+        
+        w->next_photon = first;
+        w->end_photon = first + ENSEMBLE_CHUNK;
+        if (w->end_photon > ensemble_photons) w->end_photon = ensemble_photons;
+    }
+    
+    return w->next_photon++;
+}
+
+/* Izotropná emisia zo štartu - smer závisí iba od indexu fotónu */
+void ensemble_emit_photon(PhotonState *ps, int64_t index) {
+    uint64_t rng = sim->ensemble_seed ^ ((uint64_t)index * 0xD1B54A32D192ED03ULL);
+    float direction = (splitmix64(&rng) >> 40) * (2 * M_PI / 16777216.0);
+    
+    init_photon_state(ps, direction);
+}
+
+/* Súhrn za dokončený fotón */
+void ensemble_retire_photon(EnsembleWorker *w, const Photon *p) {
+    w->path_sum += p->optical_path_length;
+    w->intensity_sum += p->intensity;
+    w->average_intensity_sum += 1.0 / (p->optical_path_length / CELL_SIZE + 1);
+    w->group_velocity_sum += p->group_velocity;
+    w->reflections_sum += p->reflections;
+    w->refractions_sum += p->refractions;
+    w->photons++;
+}
+
+/* Prehrávanie cyklu uväzneného fotónu do privátnych polí vlákna */
+void fast_forward_ensemble_photon(EnsembleWorker *w, PhotonState *ps, const CycleTracker *ct) {
+    int64_t i = 0;
+    while (ps->photon.optical_path_length < MAX_STEPS * CELL_SIZE && 
+           ps->photon.intensity > 1e-6) {
+        
+        const CycleStep *step = &ct->steps[i];
+        float absorbed = photon_deposit(&ps->photon, step->material);
+        ensemble_deposit(w, step->cell, absorbed);
+        
+        cycle_step_apply(ps, step);
+        if (++i == ct->length) i = 0;
+    }
+    
+    cycle_finish_photon(ps);
+}
+
+/* Skalárne trasovanie fotónu do privátnych polí vlákna */
+void trace_ensemble_photon(EnsembleWorker *w, PhotonState *ps) {
+    cycle_tracker_init(w->cycle, ps);
+    
+    while (ps->photon.optical_path_length < MAX_STEPS * CELL_SIZE && 
+           ps->photon.intensity > 1e-6) {
+        
+        int64_t idx = cell_index(ps->pos_x, ps->pos_y);
+        float absorbed = photon_deposit(&ps->photon, sim->world.material_id[idx]);
+        ensemble_deposit(w, idx, absorbed);
+        
+        if (!photon_move(ps)) {
+            break;
+        }
+        
+        int is_target = photon_check_target(ps);
+        if (is_target == 2) {
+            break;
+        }
+        
+        if (cycle_tracker_step(w->cycle, ps, is_target)) {
+            fast_forward_ensemble_photon(w, ps, w->cycle);
+        }
+    }
+    
+    ensemble_retire_photon(w, &ps->photon);
+}
+
+void* ensemble_trace_worker(void *arg) {
+    EnsembleWorker *w = (EnsembleWorker*)arg;
+    int64_t index;
+    
+    while ((index = ensemble_claim_photon(w)) >= 0) {
+        PhotonState ps;
+        ensemble_emit_photon(&ps, index);
+        trace_ensemble_photon(w, &ps);
+    }
+    
+    return NULL;
+}
+
+/* Zlúčenie privátnych dlaždíc do sveta - každé vlákno vlastní rozsah
+ * dlaždíc, preto zápisy nekolidujú. Prechádzajú sa iba dlaždice, ktoré
+ * niektoré vlákno alokovalo, a bunky s návštevou; entropické súčty sa
+ * menia o rozdiel ako pri kroku fotónu. Teplota a energia sú priemery
+ * cez ensemble. */
+void* ensemble_merge_worker(void *arg) {
+    EnsembleMerge *m = (EnsembleMerge*)arg;
+    float inv_photons = 1.0 / ensemble_photons;
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    EnsembleTile *tiles[ensemble_threads];
+    
+    memset(&m->acc, 0, sizeof(m->acc));
+    m->max_temperature = 0.0;
+    m->min_temperature = 1000.0;
+    
+    for (int64_t k = m->tile_begin; k < m->tile_end; k++) {
+        int32_t tile_count = 0;
+        for (int32_t t = 0; t < ensemble_threads; t++) {
+            if (sim->ensemble_workers[t].tiles[k]) tiles[tile_count++] = sim->ensemble_workers[t].tiles[k];
+        }
+        if (tile_count == 0) continue;
+        
+        int64_t first = k << ENSEMBLE_TILE_BITS;
+        int64_t count = cells - first < ENSEMBLE_TILE_CELLS ? cells - first : ENSEMBLE_TILE_CELLS;
+        for (int64_t i = 0; i < count; i++) {
+            int32_t visits = 0;
+            float energy = 0.0;
+            float heat = 0.0;
+            
+            for (int32_t t = 0; t < tile_count; t++) {
+                visits += tiles[t]->visits[i];
+                energy += tiles[t]->energy[i];
+                heat += tiles[t]->heat[i];
+            }
+            if (visits == 0) continue;
+            
+            int64_t idx = first + i;
+            int32_t old_visits = sim->world.photon_visits[idx];
+            float old_temperature = sim->world.temperature[idx];
+            int32_t cell_visits = old_visits + visits;
+            float temperature = old_temperature + heat * inv_photons;
+            sim->world.photon_visits[idx] = cell_visits;
+            sim->world.energy_density[idx] += energy * inv_photons;
+            sim->world.temperature[idx] = temperature;
+            
+            m->acc.total_visits += visits;
+            m->acc.visit_log_sum += xlogx(cell_visits) - xlogx(old_visits);
+            m->acc.total_temperature += (double)temperature - old_temperature;
+            m->acc.temperature_log_sum += xlogx(temperature) - xlogx(old_temperature);
+            if (old_visits == 0) m->acc.visited_cells++;
+            
+            if (temperature > m->max_temperature) m->max_temperature = temperature;
+            if (temperature < m->min_temperature) m->min_temperature = temperature;
+        }
+    }
+    
+    return NULL;
+}
+
+/* Ensemble N fotónov na všetkých jadrách; metriky sú priemery cez ensemble */
+void simulate_photon_ensemble() {
+    if (!sim->quiet) {
+        printf("\n[KYBERNAUT-LIGHT v3.1] Ensemble optická simulácia\n");
+        printf("==============================================================\n");
+        printf("  • Fotóny: %"PRId64" (izotropná emisia zo štartu)\n", ensemble_photons);
+        printf("  • Vlákna: %"PRId32"\n", ensemble_threads);
+        printf("  • Rozmer sveta: %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
+        printf("==============================================================\n");
+    }
+    
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    sim->ensemble_tiles = (cells + ENSEMBLE_TILE_CELLS - 1) >> ENSEMBLE_TILE_BITS;
+    size_t thread_count = ensemble_threads > 0 ? (size_t)ensemble_threads : 1;
+    sim->ensemble_workers = (EnsembleWorker*)calloc(thread_count, sizeof(EnsembleWorker));
+    if (!sim->ensemble_workers) {
+        printf("Chyba: Nedostatok pamäte pre ensemble\n");
+        exit(1);
+    }
+    
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        sim->ensemble_workers[t].tiles = (EnsembleTile**)calloc(sim->ensemble_tiles, sizeof(EnsembleTile*));
+        sim->ensemble_workers[t].cycle = (CycleTracker*)malloc(sizeof(CycleTracker));
+        if (!sim->ensemble_workers[t].tiles || !sim->ensemble_workers[t].cycle) {
+            printf("Chyba: Nedostatok pamäte pre privátne polia vlákna %"PRId32"\n", t);
+            exit(1);
+        }
+    }
+    
+    // Fáza 1: trasovanie
+    sim->ensemble_next_photon = 0;
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        simulation_thread_create(&sim->ensemble_workers[t].thread, ensemble_trace_worker, &sim->ensemble_workers[t]);
+    }
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        pthread_join(sim->ensemble_workers[t].thread, NULL);
+    }
+    
+    // Fáza 2: zlúčenie po rozsahoch dlaždíc
+    EnsembleMerge *merges = (EnsembleMerge*)calloc(thread_count, sizeof(EnsembleMerge));
+    if (!merges) {
+        printf("Chyba: Nedostatok pamäte pre zlúčenie ensemblu\n");
+        exit(1);
+    }
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        merges[t].tile_begin = sim->ensemble_tiles * t / ensemble_threads;
+        merges[t].tile_end = sim->ensemble_tiles * (t + 1) / ensemble_threads;
+        simulation_thread_create(&merges[t].thread, ensemble_merge_worker, &merges[t]);
+    }
+    
+    int64_t tiles_used = 0;
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        pthread_join(merges[t].thread, NULL);
+        
+        sim->entropy_acc.total_visits += merges[t].acc.total_visits;
+        sim->entropy_acc.visit_log_sum += merges[t].acc.visit_log_sum;
+        sim->entropy_acc.total_temperature += merges[t].acc.total_temperature;
+        sim->entropy_acc.temperature_log_sum += merges[t].acc.temperature_log_sum;
+        sim->entropy_acc.visited_cells += merges[t].acc.visited_cells;
+        
+        if (merges[t].max_temperature > sim->metrics.max_temperature) {
+            sim->metrics.max_temperature = merges[t].max_temperature;
+        }
+        if (merges[t].min_temperature < sim->metrics.min_temperature) {
+            sim->metrics.min_temperature = merges[t].min_temperature;
+        }
+    }
+    free(merges);
+    
+    // Priemery cez ensemble
+    EnsembleWorker total;
+    memset(&total, 0, sizeof(total));
+    for (int32_t t = 0; t < ensemble_threads; t++) {
+        EnsembleWorker *w = &sim->ensemble_workers[t];
+        total.path_sum += w->path_sum;
+        total.intensity_sum += w->intensity_sum;
+        total.average_intensity_sum += w->average_intensity_sum;
+        total.energy_sum += w->energy_sum;
+        total.group_velocity_sum += w->group_velocity_sum;
+        total.reflections_sum += w->reflections_sum;
+        total.refractions_sum += w->refractions_sum;
+        total.steps += w->steps;
+        total.photons += w->photons;
+        
+        tiles_used += w->tile_count;
+        for (int64_t k = 0; k < sim->ensemble_tiles; k++) {
+            free(w->tiles[k]);
+        }
+        free(w->tiles);
+        free(w->cycle);
+    }
+    free(sim->ensemble_workers);
+    sim->ensemble_workers = NULL;
+    
+    double n = (double)total.photons;
+    init_photon(&sim->photon);
+    sim->photon.optical_path_length = total.path_sum / n;
+    sim->photon.intensity = total.intensity_sum / n;
+    sim->photon.group_velocity = total.group_velocity_sum / n;
+    sim->photon.reflections = (int32_t)llround(total.reflections_sum / n);
+    sim->photon.refractions = (int32_t)llround(total.refractions_sum / n);
+    
+    sim->metrics.total_optical_path = sim->photon.optical_path_length;
+    sim->metrics.total_energy_absorbed = total.energy_sum / n;
+    sim->metrics.average_intensity = total.average_intensity_sum / n;
+    
+    calculate_information_entropy();
+    calculate_thermal_entropy();
+    calculate_quantum_entropy(&sim->photon);
+    
+    sim->metrics.visited_cells = sim->entropy_acc.visited_cells;
+    sim->metrics.coverage = (float)sim->metrics.visited_cells / sim->metrics.total_cells * 100.0;
+    
+    if (sim->metrics.total_energy_absorbed > 0) {
+        sim->metrics.photon_efficiency = sim->photon.optical_path_length / sim->metrics.total_energy_absorbed;
+    } else {
+        sim->metrics.photon_efficiency = 0.0;
+    }
+    
+    sim->ensemble_steps = total.steps;
+    sim->ensemble_tiles_used = tiles_used;
+}
+
+/* ==================== REDUKCIA TEPELNÉHO POĽA (SIMD) ==================== */
+
+/* Pole teplôt leží v aréne súvisle, blok redukcie (kybernaut_common.h) je
+ * preto THERMAL_BLOCK po sebe idúcich buniek. Bežný beh entropiu číta z
+ * akumulátorov, jadro slúži krížovej kontrole a meraniu. */
+#define THERMAL_BLOCK 4096          // Prvky jedného float súčtu v pruhoch
+
+KERNEL_INLINE void* thermal_worker_body(int width, void *arg) {
+    ThermalWorker *w = (ThermalWorker*)arg;
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    
+    for (int64_t b = w->first; b * THERMAL_BLOCK < cells; b += w->stride) {
+        int64_t begin = b * THERMAL_BLOCK;
+        int64_t count = cells - begin < THERMAL_BLOCK ? cells - begin : THERMAL_BLOCK;
+        thermal_block_sums(width, sim->world.temperature + begin, count, &w->sum, &w->xlogx_sum);
+    }
+    
+    return NULL;
+}
+
+KERNEL_WIDTH_VARIANTS(void*, thermal_worker, (void *arg), (arg))
+
+/* Tepelná entropia celého poľa teplôt v world_init_threads vláknach */
+float thermal_entropy_kernel() {
+    int64_t cells = (int64_t)sim->dimension * sim->dimension;
+    int64_t blocks = (cells + THERMAL_BLOCK - 1) / THERMAL_BLOCK;
+    int32_t threads = sim->world_init_threads < blocks ? sim->world_init_threads : (int32_t)blocks;
+    return thermal_entropy_reduce(thermal_worker, threads, (double)cells);
+}
+
+/* Skalárny dvojprechod proti jadru na čerstvom svete: čas, GB/s, bunky/s */
+void run_entropy_benchmark() {
+    double cells = (double)sim->dimension * sim->dimension;
+    double bytes = cells * sizeof(float);
+    
+    double start = wall_time();
+    float scalar = 0.0;
+    for (int r = 0; r < BENCH_ENTROPY_REPEATS; r++) {
+        scalar = calculate_thermal_entropy_rescan();
+    }
+    double scalar_time = (wall_time() - start) / BENCH_ENTROPY_REPEATS;
+    
+    start = wall_time();
+    float kernel = 0.0;
+    for (int r = 0; r < BENCH_ENTROPY_REPEATS; r++) {
+        kernel = thermal_entropy_kernel();
+    }
+    double kernel_time = (wall_time() - start) / BENCH_ENTROPY_REPEATS;
+    
+    printf("\nTepelná entropia %"PRId32"x%"PRId32" (%d opakovaní, %"PRId32" vlákien, jadro %s, SIMD šírka %d):\n",
+           sim->dimension, sim->dimension, BENCH_ENTROPY_REPEATS, sim->world_init_threads,
+           kernel_names[kernel_variant], kernel_width[kernel_variant]);
+    printf("  Skalárny dvojprechod: S=%.6f, %8.3f ms, %6.2f GB/s, %8.1f M buniek/s\n",
+           scalar, scalar_time * 1000.0, 2.0 * bytes / scalar_time / 1e9, cells / scalar_time / 1e6);
+    printf("  SIMD jadro:           S=%.6f, %8.3f ms, %6.2f GB/s, %8.1f M buniek/s\n",
+           kernel, kernel_time * 1000.0, bytes / kernel_time / 1e9, cells / kernel_time / 1e6);
+    printf("  Zrýchlenie: %.1fx, rozdiel entropie %.2e\n",
+           scalar_time / kernel_time, fabs(scalar - kernel));
+}
+
+/* ==================== REPLIKÁTY A ŠTATISTIKA ==================== */
+
+/* Jeden replikát: svet a fotón zo seedu, simulácia bez výpisu.
+ * Prechodové tabuľky pripravil program pred spustením vlákien. */
+void replicate_run(uint64_t seed, ReplicateResult *r) {
+    sim->world.seed = seed;
+    sim->ensemble_seed = seed;
+    if (sim->world.procedural) {
+        free(sim->world.touched);
+        sim->world.touched_count = 0;
+        init_procedural_world(sim->dimension);
+    } else {
+        init_optical_world(sim->dimension, world_dir);
+        if (sim->empty_space_skip_enabled) init_boundary_distance();
+    }
+    init_photon(&sim->photon);
+    init_metrics();
+    
+    double start = wall_time();
+    if (ensemble_photons > 1) {
+        simulate_photon_ensemble();
+    } else {
+        simulate_photon_propagation();
+    }
+    r->time = wall_time() - start;
+    replicate_record(r, seed, sim->metrics.information_entropy, sim->metrics.thermal_entropy,
+                     sim->metrics.quantum_entropy);
+}
+
+/* S --photons je replikát ensemble a každé vlákno replikátov trasuje jeho
+ * fotóny na T/P vláknach (P = počet vlákien replikátov); samostatne ho
+ * zopakuje --seed S+r --threads T/P */
+void replicate_configure(int32_t threads, int32_t workers) {
+    ensemble_threads = threads / workers;
+    if (ensemble_threads > ensemble_photons) ensemble_threads = (int32_t)ensemble_photons;
+    if (ensemble_photons > 1) {
+        printf(", ensemble %"PRId64" fotónov na %"PRId32" vláknach", ensemble_photons, ensemble_threads);
+    }
+}
+
+/* Stav vlákna replikátov: nastavenia programu, vlastný svet a aréna */
+SimulationState *replicate_state_create() {
+    SimulationState *state = (SimulationState*)malloc(sizeof(SimulationState));
+    if (!state) {
+        printf("Chyba: Nedostatok pamäte pre stav replikátu\n");
+        exit(1);
+    }
+    *state = *sim;
+    state->quiet = 1;
+    return state;
+}
+
+void replicate_state_destroy(SimulationState *state) {
+    arena_release(&state->world_arena);
+    free(state->world.touched);
+    free(state);
+}
+
+/* ==================== ROZHRANIE KNIŽNICE ==================== */
+
+/* Variant jadier: vynútený cez --kernel=, inak najširší, ktorý CPU podporuje.
+ * Varianty má rozhodnutie o prechode a redukcia teplôt. */
+void kernel_select() {
+    if (kernel_forced >= 0) {
+        kernel_variant = (KernelVariant)kernel_forced;
+    } else {
+        kernel_variant = KERNEL_SCALAR;
+        for (int v = KERNEL_SCALAR; v < KERNEL_VARIANTS; v++) {
+            if (kernel_supported((KernelVariant)v)) kernel_variant = (KernelVariant)v;
+        }
+    }
+    
+    table_transition_decision = table_transition_decision_variants[kernel_variant];
+    thermal_worker = thermal_worker_variants[kernel_variant];
+}
+
+/* Simulácia rozhrania (kybernaut_light.h) nesie vlastný stav behu a
+ * rozpracovaný beh; operácia naň na svoj čas nastaví sim volajúceho
+ * vlákna. Rôzne simulácie sa tak dajú volať aj súčasne z viacerých
+ * vlákien. Prechodové tabuľky a varianty jadier nezávisia od sveta a
+ * pripravia sa raz. */
+struct LightSimulation {
+    SimulationState state;
+    PropagationRun run;
+    CycleFlush saved_flush;       // Záloha prehrávania počas čítania metrík
+};
+
+pthread_once_t light_library_once = PTHREAD_ONCE_INIT;
+
+void light_library_init() {
+    kernel_select();
+    init_transition_tables();
+}
+
+LightSimulation *light_create(const LightConfig *config) {
+    if (config->dimension < 5 || (config->procedural && config->world_dir)) return NULL;
+    LightSimulation *simulation = (LightSimulation*)calloc(1, sizeof(LightSimulation));
+    if (!simulation) return NULL;
+    pthread_once(&light_library_once, light_library_init);
+    
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    sim->dimension = config->dimension;
+    sim->world.procedural = config->procedural;
+    sim->world.seed = config->seed;
+    sim->ensemble_seed = config->seed;
+    sim->world_init_threads = config->threads > 0 ? config->threads : 1;
+    sim->empty_space_skip_enabled = 1;
+    sim->quiet = 1;
+    
+    if (sim->world.procedural) {
+        init_procedural_world(sim->dimension);
+    } else {
+        init_optical_world(sim->dimension, config->world_dir);
+    }
+    
+    sim->start_x = sim->dimension / 2;
+    sim->start_y = sim->dimension / 2;
+    sim->target_x = 0;
+    sim->target_y = 0;
+    init_photon(&sim->photon);
+    init_metrics();
+    if (sim->empty_space_skip_enabled && transition_tables_enabled && !sim->world.procedural) {
+        init_boundary_distance();
+    } else {
+        sim->empty_space_skip_enabled = 0;
+    }
+    propagation_begin(&simulation->run);
+    sim = saved_sim;
+    
+    return simulation;
+}
+
+int64_t light_step(LightSimulation *simulation, int64_t steps) {
+    if (simulation->run.finished) return 0;
+    
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    int64_t done = 0;
+    while (done < steps) {
+        int64_t applied = propagation_step(&simulation->run, steps - done);
+        if (applied == 0) break;
+        done += applied;
+    }
+    if (done < steps) {
+        propagation_finish(&simulation->run);
+        simulation->run.finished = 1;
+    }
+    sim = saved_sim;
+    
+    return done;
+}
+
+/* Metriky uprostred rýchleho posunu: akumulátory a fáza fotónu sa dorovnajú
+ * iba na kópii, aby ďalšie kroky počítali rovnako ako CLI */
+void light_replay_metrics(LightSimulation *simulation) {
+    PropagationRun *run = &simulation->run;
+    EntropyAccumulator saved_acc = sim->entropy_acc;
+    simulation->saved_flush = run->replay.flush;
+    PhotonState saved_ps = run->ps;
+    
+    cycle_flush_accumulators(&run->cycle, &run->replay.flush);
+    cycle_finish_photon(&run->ps);
+    propagation_finish(run);
+    
+    sim->entropy_acc = saved_acc;
+    run->replay.flush = simulation->saved_flush;
+    run->ps = saved_ps;
+}
+
+void light_metrics(LightSimulation *simulation, LightMetrics *out) {
+    SimulationState *saved_sim = sim;
+    sim = &simulation->state;
+    if (simulation->run.replay.active) {
+        light_replay_metrics(simulation);
+    } else if (!simulation->run.finished) {
+        propagation_finish(&simulation->run);
+    }
+    
+    out->information_entropy = sim->metrics.information_entropy;
+    out->thermal_entropy = sim->metrics.thermal_entropy;
+    out->quantum_entropy = sim->metrics.quantum_entropy;
+    out->delta_s = sim->metrics.thermal_entropy - sim->metrics.information_entropy;
+    out->ratio = sim->metrics.information_entropy > 0 ?
+                 sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0;
+    out->coverage = sim->metrics.coverage;
+    out->visited_cells = sim->metrics.visited_cells;
+    out->optical_path = sim->photon.optical_path_length;
+    out->intensity = sim->photon.intensity;
+    out->reflections = sim->photon.reflections;
+    out->refractions = sim->photon.refractions;
+    out->steps = simulation->run.steps;
+    out->finished = simulation->run.finished;
+    sim = saved_sim;
+}
+
+void light_destroy(LightSimulation *simulation) {
+    if (!simulation) return;
+    arena_release(&simulation->state.world_arena);
+    free(simulation->state.world.touched);
+    free(simulation);
+}
+
+/* ==================== HLAVNÝ PROGRAM ==================== */
+
+#ifndef KYBERNAUT_LIBRARY
+
+/* --quiet: metriky behu v jednom riadku kľúč=hodnota (názvy ako stĺpce súhrnu) */
+void print_quiet_metrics(double total_time) {
+    printf("Light Dim=%"PRId32" Seed=%"PRIu64" S_info=%.6f S_thermal=%.6f S_quantum=%.6f "
+           "DeltaS=%.6f Ratio=%.6f Coverage=%.4f Time=%.3f\n",
+           sim->dimension, sim->world.seed, sim->metrics.information_entropy, sim->metrics.thermal_entropy,
+           sim->metrics.quantum_entropy, sim->metrics.thermal_entropy - sim->metrics.information_entropy,
+           sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0,
+           sim->metrics.coverage, total_time);
+}
+
+void print_usage(const char* program) {
+    printf("Použitie: %s [voľby]\n", program);
+    printf("  --dim N        rozmer sveta (inak sa zadá interaktívne)\n");
+    printf("  --photons N    ensemble N fotónov (predvolené 1 = jeden fotón)\n");
+    printf("  --threads T    vlákna ensemblu a inicializácie (predvolené: všetky jadrá)\n");
+    printf("  --no-tables    bez prechodových tabuliek (priamy výpočet váh)\n");
+    printf("  --no-cycles    bez detekcie cyklov a rýchleho posunu\n");
+    printf("  --no-skip      bez preskakovania homogénnych oblastí\n");
+    printf("  --no-hugepages aréna sveta bez veľkých stránok (MADV_HUGEPAGE)\n");
+    printf("  --procedural   procedurálny riedky svet (iba jeden fotón)\n");
+    printf("  --seed S       seed sveta a emisie (predvolené: čas štartu)\n");
+    printf("  --init-only    iba inicializácia sveta (meranie štartu)\n");
+    printf("  --bench-entropy porovná skalárny výpočet tepelnej entropie so SIMD jadrom\n");
+    printf("  --kernel=V     variant jadier: scalar, avx2, avx512 (predvolené: podľa CPU)\n");
+    printf("  --replicates N N behov so seedmi S..S+N-1 v --threads vláknach, štatistika do CSV\n");
+    printf("                 (s --photons dostane ensemble každého vlákna replikátov zvyšné jadrá)\n");
+    printf("  --summary F    súhrn replikátov (predvolené: summary.csv)\n");
+    printf("  --world-dir D  svet zo súboru v D zdieľaného s Kybernaut-Human (vytvorí ho prvý)\n");
+    printf("  --quiet        bez baneru, priebehu a logu; jeden riadok metrík (vyžaduje --dim)\n");
+    printf("  --help         zobrazí túto nápovedu\n");
+}
+
+/* Spracovanie argumentov príkazového riadku; vráti 0 pri chybe */
+int parse_arguments(int argc, char* argv[], int32_t* dim) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (strcmp(arg, "--dim") == 0 && value) {
+            *dim = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--photons") == 0 && value) {
+            ensemble_photons = strtoll(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            ensemble_threads = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--no-tables") == 0) {
+            transition_tables_enabled = 0;
+        } else if (strcmp(arg, "--no-cycles") == 0) {
+            cycle_detection_enabled = 0;
+        } else if (strcmp(arg, "--no-skip") == 0) {
+            sim->empty_space_skip_enabled = 0;
+        } else if (strcmp(arg, "--no-hugepages") == 0) {
+            huge_pages_enabled = 0;
+        } else if (strcmp(arg, "--procedural") == 0) {
+            sim->world.procedural = 1;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            sim->world.seed = strtoull(value, NULL, 10);
+            sim->ensemble_seed = sim->world.seed;
+            i++;
+        } else if (strcmp(arg, "--init-only") == 0) {
+            init_only = 1;
+        } else if (strcmp(arg, "--bench-entropy") == 0) {
+            bench_entropy = 1;
+        } else if (strcmp(arg, "--replicates") == 0 && value) {
+            replicate_count = (int32_t)strtol(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--summary") == 0 && value) {
+            replicate_summary = value;
+            i++;
+        } else if (strcmp(arg, "--world-dir") == 0 && value) {
+            world_dir = value;
+            i++;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            sim->quiet = 1;
+        } else if (strncmp(arg, "--kernel=", 9) == 0) {
+            kernel_forced = kernel_lookup(arg + 9);
+            if (kernel_forced < 0) {
+                printf("Chyba: Neznámy variant jadier '%s' (scalar, avx2, avx512)\n", arg + 9);
+                return 0;
+            }
+        } else {
+            printf("Chyba: Neznáma voľba '%s'\n", arg);
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    
+    // Tichý beh je pre skripty, nesmie čakať na rozmer ani potvrdenie
+    if (sim->quiet && *dim <= 0) {
+        printf("Chyba: --quiet potrebuje --dim.\n");
+        return 0;
+    }
+    
+    if (ensemble_photons < 1 || ensemble_threads < 0) {
+        printf("Chyba: Neplatný počet fotónov alebo vlákien.\n");
+        return 0;
+    }
+    
+    if (kernel_forced >= 0 && !kernel_supported((KernelVariant)kernel_forced)) {
+        printf("Chyba: CPU nepodporuje variant jadier %s.\n", kernel_names[kernel_forced]);
+        return 0;
+    }
+    
+    // Rozptyl potrebuje aspoň dva behy
+    if (replicate_count < 0 || replicate_count == 1) {
+        printf("Chyba: --replicates potrebuje aspoň 2 behy.\n");
+        return 0;
+    }
+    if (replicate_count > 0 && (init_only || bench_entropy)) {
+        printf("Chyba: --replicates nemožno kombinovať s --init-only ani --bench-entropy.\n");
+        return 0;
+    }
+    
+    // Jadro prechádza husté pole teplôt, procedurálny svet ho nemá
+    if (sim->world.procedural && bench_entropy) {
+        printf("Chyba: --bench-entropy potrebuje hustý svet (bez --procedural).\n");
+        return 0;
+    }
+    
+    // Procedurálny svet číta materiál z hashu pri každom kroku
+    if (sim->world.procedural && world_dir) {
+        printf("Chyba: --world-dir potrebuje hustý svet (bez --procedural).\n");
+        return 0;
+    }
+    
+    // Ensemble zlučuje súkromné polia vlákien cez celú plochu sveta
+    if (sim->world.procedural && ensemble_photons > 1) {
+        printf("Chyba: Procedurálny svet podporuje iba jeden fotón.\n");
+        return 0;
+    }
+    
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    static SimulationState state = { .empty_space_skip_enabled = 1, .world_init_threads = 1 };
+    sim = &state;
+    
+    // Bez --seed sa svet aj smery emisie odvodia od času štartu
+    sim->ensemble_seed = (uint64_t)time(NULL);
+    sim->world.seed = sim->ensemble_seed;
+    
+    int32_t cli_dimension = 0;
+    if (!parse_arguments(argc, argv, &cli_dimension)) {
+        return 1;
+    }
+    kernel_select();
+    if (ensemble_threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        ensemble_threads = cores > 0 ? (int32_t)cores : 1;
+    }
+    sim->world_init_threads = ensemble_threads;
+    if (ensemble_threads > ensemble_photons) {
+        ensemble_threads = (int32_t)ensemble_photons;
+    }
+    
+
+    if (!sim->quiet) {
+        printf("╔══════════════════════════════════════════════════════════════╗\n");
+        printf("║          KYBERNAUT-LIGHT v3.1 - OPTICKÁ VERZIA             ║\n");
+        printf("║      (Fyzikálne korektná simulácia fotónu)                ║\n");
+        printf("║                PODPORA PRE VEĽKÉ MRIEŽKY                  ║\n");
+        printf("╚══════════════════════════════════════════════════════════════╝\n\n");
+        
+        printf("OPTICKÁ KOREKTNOSŤ:\n");
+        printf("  • Snellov zákon a Fresnelove koeficienty\n");
+        printf("  • Beer-Lambertov zákon absorpcie\n");
+        printf("  • Projekcia 3D optiky do 2D\n");
+        printf("  • Interferenčné a fázové efekty\n\n");
+    }
+    
+    if (cli_dimension > 0) {
+        sim->dimension = cli_dimension;
+        if (sim->dimension < 5) {
+            printf("Chyba: Neplatný rozmer.\n");
+            return 1;
+        }
+    } else {
+        printf("Zadaj rozmer sveta (napr. 15-1000): ");
+        if (scanf("%"SCNd32, &sim->dimension) != 1 || sim->dimension < 5) {
+            printf("Chyba: Neplatný rozmer.\n");
+            return 1;
+        }
+    }
+    
+    // Rozmer z príkazového riadku sa považuje za potvrdený
+    if (sim->dimension > 1000 && cli_dimension == 0 && !sim->world.procedural) {
         printf("POZOR: Veľký rozmer %"PRId32"x%"PRId32" môže vyžadovať veľa pamäte (%.2f MB)\n",
-               dimension, dimension, 
-               dimension * dimension * sizeof(OpticalNode) / (1024.0 * 1024.0));
+               sim->dimension, sim->dimension, 
+               (double)sim->dimension * sim->dimension * WORLD_BYTES_PER_CELL / (1024.0 * 1024.0));
         printf("Naozaj pokračovať? (a/n): ");
         char confirm;
         scanf(" %c", &confirm);
         if (confirm != 'a' && confirm != 'A') return 0;
     }
     
-    init_optical_world(dimension);
+    // Jadrá delia replikáty, každý svet inicializuje jedno vlákno
+    if (replicate_count > 0) {
+        int32_t workers = sim->world_init_threads;
+        sim->world_init_threads = 1;
+        sim->start_x = sim->dimension / 2;
+        sim->start_y = sim->dimension / 2;
+        sim->target_x = 0;
+        sim->target_y = 0;
+        init_transition_tables();
+        if (!transition_tables_enabled || sim->world.procedural) {
+            sim->empty_space_skip_enabled = 0;
+        }
+        return run_replicates(sim->world.seed, workers, sim->dimension);
+    }
+    
+    double world_start = wall_time();
+    if (sim->world.procedural) {
+        init_procedural_world(sim->dimension);
+    } else {
+        init_optical_world(sim->dimension, world_dir);
+    }
+    double world_time = wall_time() - world_start;
+    if (!sim->quiet) {
+        printf("Svet pripravený za %.3f s (seed %"PRIu64")\n", world_time, sim->world.seed);
+    }
+    if (sim->world_arena.base && !sim->quiet) {
+        printf("  • Aréna: %.1f MB, mmap %.3f ms, veľké stránky: %s, rezidentná pamäť %.1f MB\n",
+               sim->world_arena.capacity / 1048576.0, sim->world_arena.alloc_time * 1000.0,
+               sim->world_arena.huge_pages ? "áno" : "nie", resident_memory() / 1048576.0);
+    }
+    
+    if (bench_entropy) {
+        run_entropy_benchmark();
+    }
+    if (init_only || bench_entropy) {
+        arena_release(&sim->world_arena);
+        free(sim->world.touched);
+        return 0;
+    }
     
-    start_x = dimension / 2;
-    start_y = dimension / 2;
-    target_x = 0;
-    target_y = 0;
+    sim->start_x = sim->dimension / 2;
+    sim->start_y = sim->dimension / 2;
+    sim->target_x = 0;
+    sim->target_y = 0;
     
-    init_photon();
+    init_photon(&sim->photon);
     init_metrics();
     
-    printf("\nŠtart: [%"PRId32",%"PRId32"], Ciele: Domov[0,0] -> Bar[%"PRId32",%"PRId32"]\n",
-           start_x, start_y, dimension-1, dimension-1);
-    printf("Optické parametre:\n");
-    printf("  • Fotón: λ=%.1f nm, E=%.2e J\n", WAVELENGTH*1e9, PHOTON_ENERGY);
-    printf("  • Rozlíšenie: %.1f µm/bunka\n", CELL_SIZE*1e6);
-    printf("  • Časové rozlíšenie: %.1f fs/krok\n", TIME_STEP*1e15);
-    printf("  • Maximálny počet krokov: %d\n\n", MAX_STEPS);
+    if (!sim->quiet) {
+        printf("\nŠtart: [%"PRId32",%"PRId32"], Ciele: Domov[0,0] -> Bar[%"PRId32",%"PRId32"]\n",
+               sim->start_x, sim->start_y, sim->dimension-1, sim->dimension-1);
+        printf("Optické parametre:\n");
+        printf("  • Fotón: λ=%.1f nm, E=%.2e J\n", WAVELENGTH*1e9, PHOTON_ENERGY);
+        printf("  • Rozlíšenie: %.1f µm/bunka\n", CELL_SIZE*1e6);
+        printf("  • Časové rozlíšenie: %.1f fs/krok\n", TIME_STEP*1e15);
+        printf("  • Maximálny počet krokov: %d\n", MAX_STEPS);
+    }
+    // Tabuľky sa postavia vždy (zlomok milisekundy), --no-tables vypína
+    // iba ich použitie v rozhodovaní
+    double table_start = wall_time();
+    init_transition_tables();
+    if (!sim->quiet && transition_tables_enabled) {
+        printf("  • Prechodové tabuľky: %d stavov smeru, %.0f kB, %.2f ms\n",
+               DIRECTION_STATES, sizeof(TransitionTables) / 1024.0,
+               (wall_time() - table_start) * 1000.0);
+    } else if (!sim->quiet) {
+        printf("  • Prechodové tabuľky: vypnuté\n");
+    }
+    // Preskakovanie používa materiálové členy z tabuliek
+    if (sim->empty_space_skip_enabled && transition_tables_enabled && !sim->world.procedural) {
+        double skip_start = wall_time();
+        int64_t uniform_cells = init_boundary_distance();
+        if (!sim->quiet) {
+            printf("  • Homogénne oblasti: %.2f%% buniek bez rozhrania, %.2f ms\n\n",
+                   100.0 * uniform_cells / ((double)sim->dimension * sim->dimension),
+                   (wall_time() - skip_start) * 1000.0);
+        }
+    } else {
+        sim->empty_space_skip_enabled = 0;
+        if (!sim->quiet) printf("  • Preskakovanie homogénnych oblastí: vypnuté\n\n");
+    }
+    
+    double start_time = wall_time();
+    if (ensemble_photons > 1) {
+        simulate_photon_ensemble();
+    } else {
+        simulate_photon_propagation();
+    }
+    double total_time = wall_time() - start_time;
     
-    clock_t start_time = clock();
-    simulate_photon_propagation();
-    clock_t end_time = clock();
-    double total_time = (double)(end_time - start_time) / CLOCKS_PER_SEC;
+    if (sim->quiet) {
+        print_quiet_metrics(total_time);
+        arena_release(&sim->world_arena);
+        free(sim->world.touched);
+        return 0;
+    }
     
     printf("\n══════════════════════════════════════════════════════════════\n");
     printf("              VÝSLEDKY KYBERNAUT-LIGHT v3.1\n");
     printf("══════════════════════════════════════════════════════════════\n\n");
     
     printf("OPTICKÉ METRIKY:\n");
-    printf("  Celková optická dráha: %.1f µm\n", metrics.total_optical_path * 1e6);
-    printf("  Konečná intenzita: %.3f\n", photon.intensity);
-    printf("  Odrazy/Lomy: %"PRId32"/%"PRId32"\n", photon.reflections, photon.refractions);
-    printf("  Koherenčná dĺžka: %.1f mm\n", photon.coherence_length * 1e3);
+    printf("  Celková optická dráha: %.1f µm\n", sim->metrics.total_optical_path * 1e6);
+    printf("  Konečná intenzita: %.3f\n", sim->photon.intensity);
+    printf("  Odrazy/Lomy: %"PRId32"/%"PRId32"\n", sim->photon.reflections, sim->photon.refractions);
+    printf("  Koherenčná dĺžka: %.1f mm\n", sim->photon.coherence_length * 1e3);
     printf("  Čas simulácie: %.3f s\n", total_time);
+    printf("  Rezidentná pamäť: %.1f MB (aréna %.1f MB, mmap %.3f ms)\n",
+           resident_memory() / 1048576.0, sim->world_arena.capacity / 1048576.0,
+           sim->world_arena.alloc_time * 1000.0);
+    printf("  Jadrá: %s (%s)\n", kernel_names[kernel_variant],
+           kernel_forced >= 0 ? "--kernel" : "podľa CPU");
+    if (ensemble_photons > 1) {
+        printf("  Ensemble: %"PRId64" fotónov na %"PRId32" vláknach (priemery)\n",
+               ensemble_photons, ensemble_threads);
+        printf("  Priepustnosť: %.0f fotónov/s, %.3e krokov/s\n",
+               ensemble_photons / total_time, sim->ensemble_steps / total_time);
+        printf("  Privátne dlaždice: %"PRId64" (%.1f MB)\n",
+               sim->ensemble_tiles_used, sim->ensemble_tiles_used * sizeof(EnsembleTile) / 1048576.0);
+    }
     
     printf("\nENTROPICKÁ ANALÝZA (normalizované 0-1):\n");
-    printf("  Informačná entropia (S_info): %.4f\n", metrics.information_entropy);
-    printf("  Tepelná entropia (S_thermal): %.4f\n", metrics.thermal_entropy);
-    printf("  Kvantová entropia (S_quantum): %.4f\n", metrics.quantum_entropy);
+    printf("  Informačná entropia (S_info): %.4f\n", sim->metrics.information_entropy);
+    printf("  Tepelná entropia (S_thermal): %.4f\n", sim->metrics.thermal_entropy);
+    printf("  Kvantová entropia (S_quantum): %.4f\n", sim->metrics.quantum_entropy);
     printf("  Rozdiel S_thermal - S_info: %.4f\n", 
-           metrics.thermal_entropy - metrics.information_entropy);
+           sim->metrics.thermal_entropy - sim->metrics.information_entropy);
     printf("  Pomer S_thermal/S_info: %.3f\n",
-           metrics.information_entropy > 0 ? metrics.thermal_entropy / metrics.information_entropy : 0);
+           sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0);
     
     printf("\nTERMODYNAMICKÉ METRIKY:\n");
-    printf("  Absorbovaná energia: %.3e J\n", metrics.total_energy_absorbed);
+    printf("  Absorbovaná energia: %.3e J\n", sim->metrics.total_energy_absorbed);
     printf("  Teplotný rozsah: %.1fK - %.1fK\n", 
-           metrics.min_temperature, metrics.max_temperature);
-    printf("  Efektivita fotónu: %.3e m/J\n", metrics.photon_efficiency);
+           sim->metrics.min_temperature, sim->metrics.max_temperature);
+    printf("  Efektivita fotónu: %.3e m/J\n", sim->metrics.photon_efficiency);
     
     printf("\nEXPLORAČNÉ METRIKY:\n");
     printf("  Pokrytie sveta: %"PRId64"/%"PRId64" buniek (%.1f%%)\n",
-           metrics.visited_cells, metrics.total_cells, metrics.coverage);
-    printf("  Priemerná intenzita: %.3f\n", metrics.average_intensity);
+           sim->metrics.visited_cells, sim->metrics.total_cells, sim->metrics.coverage);
+    printf("  Priemerná intenzita: %.3f\n", sim->metrics.average_intensity);
+    if (sim->world.procedural) {
+        printf("  Procedurálny svet: %"PRId64" uložených buniek, %.1f kB, štart %.3f ms\n",
+               sim->world.touched_count, sim->world.touched_capacity * sizeof(SparseCell) / 1024.0,
+               world_time * 1000.0);
+    }
     
     // VALIDÁCIA
     printf("\n══════════════════════════════════════════════════════════════\n");
@@ -694,38 +2623,38 @@ int main() {
     
     int validation_passed = 1;
     
-    if (metrics.information_entropy < 0 || metrics.information_entropy > 1) {
-        printf("✗ S_info mimo rozsahu 0-1: %.4f\n", metrics.information_entropy);
+    if (sim->metrics.information_entropy < 0 || sim->metrics.information_entropy > 1) {
+        printf("✗ S_info mimo rozsahu 0-1: %.4f\n", sim->metrics.information_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_info v rozsahu 0-1: %.4f\n", metrics.information_entropy);
+        printf("✓ S_info v rozsahu 0-1: %.4f\n", sim->metrics.information_entropy);
     }
     
-    if (metrics.thermal_entropy < 0 || metrics.thermal_entropy > 1) {
-        printf("✗ S_thermal mimo rozsahu 0-1: %.4f\n", metrics.thermal_entropy);
+    if (sim->metrics.thermal_entropy < 0 || sim->metrics.thermal_entropy > 1) {
+        printf("✗ S_thermal mimo rozsahu 0-1: %.4f\n", sim->metrics.thermal_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_thermal v rozsahu 0-1: %.4f\n", metrics.thermal_entropy);
+        printf("✓ S_thermal v rozsahu 0-1: %.4f\n", sim->metrics.thermal_entropy);
     }
     
-    if (metrics.quantum_entropy < 0 || metrics.quantum_entropy > 1) {
-        printf("✗ S_quantum mimo rozsahu 0-1: %.4f\n", metrics.quantum_entropy);
+    if (sim->metrics.quantum_entropy < 0 || sim->metrics.quantum_entropy > 1) {
+        printf("✗ S_quantum mimo rozsahu 0-1: %.4f\n", sim->metrics.quantum_entropy);
         validation_passed = 0;
     } else {
-        printf("✓ S_quantum v rozsahu 0-1: %.4f\n", metrics.quantum_entropy);
+        printf("✓ S_quantum v rozsahu 0-1: %.4f\n", sim->metrics.quantum_entropy);
     }
     
-    if (photon.intensity < 0 || photon.intensity > 1) {
-        printf(" Intenzita mimo 0-1: %.3f (možno validné pre koherenciu)\n", photon.intensity);
+    if (sim->photon.intensity < 0 || sim->photon.intensity > 1) {
+        printf(" Intenzita mimo 0-1: %.3f (možno validné pre koherenciu)\n", sim->photon.intensity);
     } else {
-        printf("✓ Intenzita v rozsahu 0-1: %.3f\n", photon.intensity);
+        printf("✓ Intenzita v rozsahu 0-1: %.3f\n", sim->photon.intensity);
     }
     
-    if (photon.group_velocity > SPEED_OF_LIGHT * 1.1) {
-        printf("✗ Skupinová rýchlosť > c: %.3e m/s\n", photon.group_velocity);
+    if (sim->photon.group_velocity > SPEED_OF_LIGHT * 1.1) {
+        printf("✗ Skupinová rýchlosť > c: %.3e m/s\n", sim->photon.group_velocity);
         validation_passed = 0;
     } else {
-        printf("✓ Skupinová rýchlosť ≤ c: %.3e m/s\n", photon.group_velocity);
+        printf("✓ Skupinová rýchlosť ≤ c: %.3e m/s\n", sim->photon.group_velocity);
     }
     
     if (validation_passed) {
@@ -742,33 +2671,41 @@ int main() {
         fprintf(f, "Optické parametre:\n");
         fprintf(f, "  Vlnová dĺžka: %.1f nm\n", WAVELENGTH * 1e9);
         fprintf(f, "  Energia fotónu: %.3e J\n", PHOTON_ENERGY);
-        fprintf(f, "  Rozmer sveta: %"PRId32"x%"PRId32"\n", dimension, dimension);
+        fprintf(f, "  Rozmer sveta: %"PRId32"x%"PRId32"\n", sim->dimension, sim->dimension);
         fprintf(f, "  Bunka: %.1e m\n", CELL_SIZE);
-        fprintf(f, "  Simulačný čas: %.3f s\n\n", total_time);
+        fprintf(f, "  Simulačný čas: %.3f s\n", total_time);
+        fprintf(f, "  Rezidentná pamäť: %.1f MB (aréna %.1f MB, mmap %.3f ms, veľké stránky: %s)\n",
+                resident_memory() / 1048576.0, sim->world_arena.capacity / 1048576.0,
+                sim->world_arena.alloc_time * 1000.0, sim->world_arena.huge_pages ? "áno" : "nie");
+        fprintf(f, "  Jadrá: %s\n", kernel_names[kernel_variant]);
+        if (ensemble_photons > 1) {
+            fprintf(f, "  Ensemble: %"PRId64" fotónov, %"PRId32" vlákien\n",
+                    ensemble_photons, ensemble_threads);
+            fprintf(f, "  Priepustnosť: %.0f fotónov/s\n", ensemble_photons / total_time);
+        }
+        fprintf(f, "\n");
         
         fprintf(f, "Entropické metriky (0-1):\n");
-        fprintf(f, "  S_info: %.4f\n", metrics.information_entropy);
-        fprintf(f, "  S_thermal: %.4f\n", metrics.thermal_entropy);
-        fprintf(f, "  S_quantum: %.4f\n", metrics.quantum_entropy);
-        fprintf(f, "  ΔS: %.4f\n", metrics.thermal_entropy - metrics.information_entropy);
+        fprintf(f, "  S_info: %.4f\n", sim->metrics.information_entropy);
+        fprintf(f, "  S_thermal: %.4f\n", sim->metrics.thermal_entropy);
+        fprintf(f, "  S_quantum: %.4f\n", sim->metrics.quantum_entropy);
+        fprintf(f, "  ΔS: %.4f\n", sim->metrics.thermal_entropy - sim->metrics.information_entropy);
         fprintf(f, "  Pomer: %.3f\n\n", 
-                metrics.information_entropy > 0 ? metrics.thermal_entropy / metrics.information_entropy : 0);
+                sim->metrics.information_entropy > 0 ? sim->metrics.thermal_entropy / sim->metrics.information_entropy : 0);
         
         fprintf(f, "Optické metriky:\n");
-        fprintf(f, "  Optická dráha: %.1f µm\n", metrics.total_optical_path * 1e6);
-        fprintf(f, "  Odrazy/Lomy: %"PRId32"/%"PRId32"\n", photon.reflections, photon.refractions);
-        fprintf(f, "  Konečná intenzita: %.3f\n", photon.intensity);
-        fprintf(f, "  Pokrytie: %.1f%%\n", metrics.coverage);
+        fprintf(f, "  Optická dráha: %.1f µm\n", sim->metrics.total_optical_path * 1e6);
+        fprintf(f, "  Odrazy/Lomy: %"PRId32"/%"PRId32"\n", sim->photon.reflections, sim->photon.refractions);
+        fprintf(f, "  Konečná intenzita: %.3f\n", sim->photon.intensity);
+        fprintf(f, "  Pokrytie: %.1f%%\n", sim->metrics.coverage);
         
         fclose(f);
         printf("\nVýsledky uložené do: %s\n", LOG_FILENAME);
     }
     
     // Uvoľnenie pamäte
-    for (int32_t i = 0; i < dimension; i++) {
-        free(world[i]);
-    }
-    free(world);
+    arena_release(&sim->world_arena);
+    free(sim->world.touched);
     
     printf("\n══════════════════════════════════════════════════════════════\n");
     printf("  OPTICKÁ SIMULÁCIA UKONČENÁ - FYZIKÁLNE VALIDOVANÁ\n");
@@ -776,3 +2713,5 @@ int main() {
     
     return 0;
 }
+
+#endif
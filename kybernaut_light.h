@@ -0,0 +1,65 @@
+/**
+ * KYBERNAUT-LIGHT v3.1 - rozhranie knižnice
+ * Autor: Peter Leukanič
+ * Rok: 2026
+ *
+ * Jednofotónová simulácia bez konzoly: svet z konfigurácie a seedu,
+ * N krokov fotónu, metriky, zrušenie. Simulácií môže byť naraz ľubovoľne
+ * veľa a kroky sa môžu striedať. Rôzne simulácie sa dajú volať súčasne
+ * z viacerých vlákien, jedna simulácia však naraz iba z jedného. Výsledok
+ * po dobehnutí je rovnaký ako
+ * `kybernaut_light --dim N --seed S --threads T --quiet`.
+ *
+ * Preklad: make lib-light (libkybernaut_light.so). Knižnica exportuje iba
+ * funkcie light_*, dá sa teda načítať spolu s libkybernaut_human.so.
+ */
+
+#ifndef KYBERNAUT_LIGHT_H
+#define KYBERNAUT_LIGHT_H
+
+#include <stdint.h>
+
+#ifndef KYBERNAUT_API
+#define KYBERNAUT_API __attribute__((visibility("default")))
+#endif
+
+typedef struct {
+    int32_t dimension;            // Rozmer sveta (aspoň 5)
+    uint64_t seed;                // Seed sveta a emisie
+    int procedural;               // 1 = procedurálny riedky svet
+    int32_t threads;              // Vlákna inicializácie a tepelnej entropie (0 = 1)
+    const char *world_dir;        // Zdieľaný súbor sveta (--world-dir), NULL = z hashu
+} LightConfig;
+
+typedef struct {
+    double information_entropy;   // S_info (0-1)
+    double thermal_entropy;       // S_thermal (0-1)
+    double quantum_entropy;       // S_quantum (0-1)
+    double delta_s;               // S_thermal − S_info
+    double ratio;                 // S_thermal / S_info (0, ak S_info = 0)
+    double coverage;              // Pokrytie [%]
+    int64_t visited_cells;
+    double optical_path;          // Optická dráha [m]
+    double intensity;             // Zostatková intenzita fotónu
+    int32_t reflections;
+    int32_t refractions;
+    int64_t steps;                // Vykonané kroky vrátane prehratých z cyklu
+    int finished;                 // 1 = fotón skončil, metriky sú záverečné
+} LightMetrics;
+
+typedef struct LightSimulation LightSimulation;
+
+/* Svet, fotón a metriky; NULL pri neplatnej konfigurácii. Chyby sveta
+ * (pamäť, súbor world_dir) ukončia proces s hlásením ako v CLI. */
+KYBERNAUT_API LightSimulation *light_create(const LightConfig *config);
+
+/* Najviac steps krokov fotónu, aj počas rýchleho posunu cyklu; vráti
+ * počet vykonaných, 0 = beh skončil */
+KYBERNAUT_API int64_t light_step(LightSimulation *sim, int64_t steps);
+
+/* Metriky aktuálneho stavu (počas behu priebežné, po skončení záverečné) */
+KYBERNAUT_API void light_metrics(LightSimulation *sim, LightMetrics *out);
+
+KYBERNAUT_API void light_destroy(LightSimulation *sim);
+
+#endif
@@ -26,7 +26,11 @@ echo "  • Počet opakovaní: $REPETITIONS"
 echo "  • Výstupný adresár: $OUTPUT_DIR"
 echo ""
 
-# Pole pre uchovávanie výsledkov
+# Súhrn zapisujú priamo programy (--summary), Human doplní t-test oproti Light
+SUMMARY_FILE="$OUTPUT_DIR/summary.csv"
+rm -f "$SUMMARY_FILE"
+THREADS=${THREADS:-$(nproc 2>/dev/null || echo 1)}
+
 declare -a light_deltaS
 declare -a light_Sinfo
 declare -a light_Squantum
@@ -37,133 +41,56 @@ declare -a human_Sinfo
 declare -a human_Squantum
 declare -a human_ratio
 
-# Funkcia pre extrakciu metrík
-extract_metrics() {
-    local log_file=$1
-    local prefix=$2
-    
-    # Extrahuj metriky pomocou grep a awk
-    local sinfo=$(grep "Informačná entropia" "$log_file" | awk '{print $4}' | tr -d ',')
-    local stherm=$(grep "Tepelná entropia" "$log_file" | awk '{print $4}' | tr -d ',')
-    local squant=$(grep "Kvantová entropia" "$log_file" | awk '{print $4}' | tr -d ',')
-    
-    # Ak nie sú hodnoty nájdené, použij predvolené
-    if [ -z "$sinfo" ]; then sinfo="0.0"; fi
-    if [ -z "$stherm" ]; then stherm="1.0"; fi
-    if [ -z "$squant" ]; then squant="0.0"; fi
-    
-    local deltaS=$(echo "$stherm - $sinfo" | bc -l)
-    local ratio=$(echo "$stherm / $sinfo" | bc -l)
-    
-    echo "$sinfo,$stherm,$squant,$deltaS,$ratio"
-}
-
 echo "=============================================="
 echo "  Krok 1: Testovanie KYBERNAUT-LIGHT"
 echo "=============================================="
 
-for ((i=1; i<=$REPETITIONS; i++)); do
-    echo ""
-    echo "--- Opakovanie $i/$REPETITIONS ---"
-    echo "$WORLD_SIZE" | ./kybernaut_light 2>&1 | tee "$OUTPUT_DIR/${LOG_PREFIX}_light_${i}.log"
-    
-    # Extrahuj metriky
-    metrics=$(extract_metrics "$OUTPUT_DIR/${LOG_PREFIX}_light_${i}.log" "light")
-    IFS=',' read -r sinfo stherm squant deltaS ratio <<< "$metrics"
-    
-    # Ulož do polí
-    light_deltaS[$i]=$deltaS
-    light_Sinfo[$i]=$sinfo
-    light_Squantum[$i]=$squant
-    light_ratio[$i]=$ratio
-    
-    echo "Light [$i]: ΔS=$deltaS, S_info=$sinfo, S_quant=$squant, Ratio=$ratio"
-    sleep 1  # Krátka pauza medzi spusteniami
-done
+# Všetky opakovania v jednom spustení: súbežné vlákna, seedy 1..REPETITIONS
+./kybernaut_light --dim $WORLD_SIZE --seed 1 --replicates $REPETITIONS --threads $THREADS \
+    --summary "$SUMMARY_FILE" 2>&1 | tee "$OUTPUT_DIR/${LOG_PREFIX}_light.log"
 
 echo ""
 echo "=============================================="
 echo "  Krok 2: Testovanie KYBERNAUT-HUMAN"
 echo "=============================================="
 
-for ((i=1; i<=$REPETITIONS; i++)); do
-    echo ""
-    echo "--- Opakovanie $i/$REPETITIONS ---"
-    echo "$WORLD_SIZE" | ./kybernaut_human 2>&1 | tee "$OUTPUT_DIR/${LOG_PREFIX}_human_${i}.log"
-    
-    # Extrahuj metriky
-    metrics=$(extract_metrics "$OUTPUT_DIR/${LOG_PREFIX}_human_${i}.log" "human")
-    IFS=',' read -r sinfo stherm squant deltaS ratio <<< "$metrics"
-    
-    # Ulož do polí
-    human_deltaS[$i]=$deltaS
-    human_Sinfo[$i]=$sinfo
-    human_Squantum[$i]=$squant
-    human_ratio[$i]=$ratio
-    
-    echo "Human [$i]: ΔS=$deltaS, S_info=$sinfo, S_quant=$squant, Ratio=$ratio"
-    sleep 1  # Krátka pauza medzi spusteniami
-done
+./kybernaut_human --dim $WORLD_SIZE --seed 1 --replicates $REPETITIONS --threads $THREADS \
+    --summary "$SUMMARY_FILE" 2>&1 | tee "$OUTPUT_DIR/${LOG_PREFIX}_human.log"
 
 echo ""
 echo "=============================================="
 echo "  ŠTATISTICKÁ ANALÝZA VÝSLEDKOV"
-echo "=============================================="
 
-# Funkcia pre výpočet priemeru
-calculate_average() {
-    local -n array=$1
-    local sum=0
-    local count=${#array[@]}
-    
-    for value in "${array[@]}"; do
-        sum=$(echo "$sum + $value" | bc -l)
-    done
-    
-    echo "scale=6; $sum / $count" | bc -l
-}
-
-# Funkcia pre výpočet smerodajnej odchýlky
-calculate_stddev() {
-    local -n array=$1
-    local avg=$2
-    local sum=0
-    local count=${#array[@]}
-    
-    for value in "${array[@]}"; do
-        diff=$(echo "$value - $avg" | bc -l)
-        sq=$(echo "$diff * $diff" | bc -l)
-        sum=$(echo "$sum + $sq" | bc -l)
-    done
-    
-    variance=$(echo "scale=8; $sum / $count" | bc -l)
-    echo "scale=6; sqrt($variance)" | bc -l
-}
-
-# Výpočty pre Light
-light_avg_deltaS=$(calculate_average light_deltaS)
-light_std_deltaS=$(calculate_stddev light_deltaS $light_avg_deltaS)
-
-light_avg_Sinfo=$(calculate_average light_Sinfo)
-light_std_Sinfo=$(calculate_stddev light_Sinfo $light_avg_Sinfo)
-
-light_avg_ratio=$(calculate_average light_ratio)
-light_std_ratio=$(calculate_stddev light_ratio $light_avg_ratio)
-
-# Výpočty pre Human
-human_avg_deltaS=$(calculate_average human_deltaS)
-human_std_deltaS=$(calculate_stddev human_deltaS $human_avg_deltaS)
-
-human_avg_Sinfo=$(calculate_average human_Sinfo)
-human_std_Sinfo=$(calculate_stddev human_Sinfo $human_avg_Sinfo)
-
-human_avg_ratio=$(calculate_average human_ratio)
-human_std_ratio=$(calculate_stddev human_ratio $human_avg_ratio)
+# Hodnoty behov, priemery, smerodajné odchýlky a t-test zo súhrnu jedným awk
+eval "$(awk -F, '
+    $3 ~ /^[0-9]+$/ {
+        m = tolower($2)
+        printf "%s_Sinfo[%d]=%s; %s_Squantum[%d]=%s; %s_deltaS[%d]=%s; %s_ratio[%d]=%s\n",
+               m, $3, $4, m, $3, $6, m, $3, $7, m, $3, $8
+    }
+    $3 == "mean" {
+        m = tolower($2)
+        printf "%s_avg_Sinfo=%.6f; %s_avg_deltaS=%.6f; %s_avg_ratio=%.6f\n", m, $4, m, $7, m, $8
+    }
+    $3 == "variance" {
+        m = tolower($2)
+        printf "%s_std_Sinfo=%.6f; %s_std_deltaS=%.6f; %s_std_ratio=%.6f\n",
+               m, sqrt($4), m, sqrt($7), m, sqrt($8)
+    }
+    $2 == "Light-Human" && $3 == "t" { printf "t_value_deltaS=%.4f\n", $7 }
+    $2 == "Light-Human" && $3 == "p" { printf "p_value_deltaS=%.3g\n", $7 }
+' "$SUMMARY_FILE" 2>/dev/null)"
+
+if [ -z "$t_value_deltaS" ]; then
+    echo "Chyba: $SUMMARY_FILE neobsahuje výsledky oboch modelov."
+    exit 1
+fi
 
 # Výpočet percentuálneho zlepšenia
-improvement_deltaS=$(echo "scale=2; (($light_avg_deltaS - $human_avg_deltaS) / $light_avg_deltaS) * 100" | bc -l)
-improvement_Sinfo=$(echo "scale=2; (($human_avg_Sinfo - $light_avg_Sinfo) / $light_avg_Sinfo) * 100" | bc -l)
-improvement_ratio=$(echo "scale=2; (($light_avg_ratio - $human_avg_ratio) / $light_avg_ratio) * 100" | bc -l)
+read improvement_deltaS improvement_Sinfo improvement_ratio <<< "$(awk \
+    -v ld=$light_avg_deltaS -v hd=$human_avg_deltaS -v ls=$light_avg_Sinfo -v hs=$human_avg_Sinfo \
+    -v lr=$light_avg_ratio -v hr=$human_avg_ratio \
+    'BEGIN { printf "%.2f %.2f %.2f", (ld - hd) / ld * 100, (hs - ls) / ls * 100, (lr - hr) / lr * 100 }')"
 
 echo ""
 echo "VÝSLEDKY ŠTATISTICKEJ ANALÝZY (n=$REPETITIONS):"
@@ -185,34 +112,19 @@ printf "  S_info: %.2f%% zvýšenie\n" $improvement_Sinfo
 printf "  Pomer: %.2f%% zníženie (bližšie k 1)\n" $improvement_ratio
 echo ""
 
-# Test štatistickej významnosti (jednoduchý t-test)
+# Welchov t-test (Light − Human) vypočítal kybernaut_human do súhrnu
 echo "ŠTATISTICKÁ VÝZNAMNOSŤ:"
 echo "----------------------"
+echo "  t-hodnota pre ΔS: $t_value_deltaS (p = $p_value_deltaS)"
 
-# Výpočet t-hodnoty pre ΔS
-deltaS_diff=$(echo "$light_avg_deltaS - $human_avg_deltaS" | bc -l)
-deltaS_pooled_var=$(echo "($light_std_deltaS * $light_std_deltaS + $human_std_deltaS * $human_std_deltaS) / 2" | bc -l)
-deltaS_se=$(echo "sqrt($deltaS_pooled_var * (1/$REPETITIONS + 1/$REPETITIONS))" | bc -l)
-t_value_deltaS=$(echo "$deltaS_diff / $deltaS_se" | bc -l)
-
-echo "  t-hodnota pre ΔS: $t_value_deltaS"
-
-# Interpretácia t-hodnoty
-if (( $(echo "$t_value_deltaS > 2.262" | bc -l) )); then  # t-kritická pre n=10, α=0.05
+if awk -v p="$p_value_deltaS" 'BEGIN { exit !(p < 0.05) }'; then
+    deltaS_significant=1
     echo "  → Rozdiel v ΔS je ŠTATISTICKY VÝZNAMNÝ (p < 0.05)"
 else
+    deltaS_significant=0
     echo "  → Rozdiel v ΔS nie je štatisticky významný"
 fi
 
-# Vytvorenie súhrnného CSV súboru
-SUMMARY_FILE="$OUTPUT_DIR/summary.csv"
-echo "Test,Model,Run,S_info,S_thermal,S_quantum,DeltaS,Ratio" > $SUMMARY_FILE
-
-for ((i=1; i<=$REPETITIONS; i++)); do
-    echo "1000x1000,Light,$i,${light_Sinfo[$i]},1.0000,${light_Squantum[$i]},${light_deltaS[$i]},${light_ratio[$i]}" >> $SUMMARY_FILE
-    echo "1000x1000,Human,$i,${human_Sinfo[$i]},1.0000,${human_Squantum[$i]},${human_deltaS[$i]},${human_ratio[$i]}" >> $SUMMARY_FILE
-done
-
 # Vytvorenie grafu pomocou gnuplot (ak je nainštalovaný)
 if command -v gnuplot &> /dev/null; then
     echo ""
@@ -263,8 +175,8 @@ set yrange [0:1]
 set style line 1 lc rgb "#FF6B6B" pt 7 ps 1.5 lw 2
 set style line 2 lc rgb "#4ECDC4" pt 9 ps 1.5 lw 2
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Light ΔS" linestyle 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Human ΔS" linestyle 2
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Light ΔS" linestyle 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Human ΔS" linestyle 2
 EOF
     
     # Graf 2: S_info porovnanie
@@ -287,8 +199,8 @@ set yrange [0:1]
 set style line 1 lc rgb "#FF6B6B" pt 7 ps 1.5 lw 2
 set style line 2 lc rgb "#4ECDC4" pt 9 ps 1.5 lw 2
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Light S_info" linestyle 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Human S_info" linestyle 2
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Light S_info" linestyle 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Human S_info" linestyle 2
 EOF
     
     # Graf 3: Pomer S_thermal/S_info
@@ -311,8 +223,8 @@ set yrange [0:20]
 set style line 1 lc rgb "#FF6B6B" pt 7 ps 1.5 lw 2
 set style line 2 lc rgb "#4ECDC4" pt 9 ps 1.5 lw 2
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Light Pomer" linestyle 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Human Pomer" linestyle 2
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Light Pomer" linestyle 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Human Pomer" linestyle 2
 EOF
     
     # Graf 4: Kombinovaný graf všetkých metrík (voliteľné)
@@ -336,8 +248,8 @@ set grid
 set key left top
 set yrange [0:1]
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Light ΔS" lc rgb "#FF6B6B" pt 7 ps 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Human ΔS" lc rgb "#4ECDC4" pt 9 ps 1
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Light ΔS" lc rgb "#FF6B6B" pt 7 ps 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:7 with linespoints title "Human ΔS" lc rgb "#4ECDC4" pt 9 ps 1
 
 # Graf 2: S_info
 set title "S_{info} (informačná entropia)"
@@ -345,8 +257,8 @@ set ylabel "S_info"
 set xlabel "Testovací beh"
 set yrange [0:1]
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Light S_info" lc rgb "#FF6B6B" pt 7 ps 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Human S_info" lc rgb "#4ECDC4" pt 9 ps 1
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Light S_info" lc rgb "#FF6B6B" pt 7 ps 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:4 with linespoints title "Human S_info" lc rgb "#4ECDC4" pt 9 ps 1
 
 # Graf 3: Pomer
 set title "Pomer S_{thermal}/S_{info}"
@@ -354,8 +266,8 @@ set ylabel "Pomer"
 set xlabel "Testovací beh"
 set yrange [0:20]
 
-plot '< grep "Light" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Light Pomer" lc rgb "#FF6B6B" pt 7 ps 1, \
-     '< grep "Human" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Human Pomer" lc rgb "#4ECDC4" pt 9 ps 1
+plot '< grep ",Light,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Light Pomer" lc rgb "#FF6B6B" pt 7 ps 1, \
+     '< grep ",Human,[0-9]" "${OUTPUT_DIR}/summary.csv"' using 3:8 with linespoints title "Human Pomer" lc rgb "#4ECDC4" pt 9 ps 1
 
 unset multiplot
 EOF
@@ -559,8 +471,8 @@ cat > $HTML_FILE << EOF
             <p><span class="stat">t-hodnota pre ΔS:</span> ${t_value_deltaS}</p>
 EOF
 
-if (( $(echo "$t_value_deltaS > 2.262" | bc -l) )); then
-    echo "<p class='highlight'>✅ Rozdiel v ΔS je ŠTATISTICKY VÝZNAMNÝ (p < 0.001)</p>" >> $HTML_FILE
+if [ $deltaS_significant -eq 1 ]; then
+    echo "<p class='highlight'>✅ Rozdiel v ΔS je ŠTATISTICKY VÝZNAMNÝ (p = ${p_value_deltaS})</p>" >> $HTML_FILE
     echo "<p>To znamená, že zlepšenie NIE JE náhodné, ale systémové a opakovateľné.</p>" >> $HTML_FILE
 else
     echo "<p class='highlight'>⚠️ Rozdiel v ΔS nie je štatisticky významný</p>" >> $HTML_FILE
@@ -654,9 +566,10 @@ cat >> $HTML_FILE << EOF
                         <div class="debug">
                             <p><strong>KYBERNAUTICKÝ KOEFICIENT:</strong></p>
                             <p>• KC = S_info / ΔS</p>
-                            <p>• Light: ${light_avg_Sinfo} / ${light_avg_deltaS} = $(echo "scale=2; $light_avg_Sinfo / $light_avg_deltaS" | bc -l)</p>
-                            <p>• Human: ${human_avg_Sinfo} / ${human_avg_deltaS} = $(echo "scale=2; $human_avg_Sinfo / $human_avg_deltaS" | bc -l)</p>
-                            <p>• Zlepšenie: ×$(echo "scale=1; ($human_avg_Sinfo / $human_avg_deltaS) / ($light_avg_Sinfo / $light_avg_deltaS)" | bc -l)</p>
+                            <p>• Light: ${light_avg_Sinfo} / ${light_avg_deltaS} = $(awk -v a=$light_avg_Sinfo -v b=$light_avg_deltaS 'BEGIN { printf "%.2f", a / b }')</p>
+                            <p>• Human: ${human_avg_Sinfo} / ${human_avg_deltaS} = $(awk -v a=$human_avg_Sinfo -v b=$human_avg_deltaS 'BEGIN { printf "%.2f", a / b }')</p>
+                            <p>• Zlepšenie: ×$(awk -v hs=$human_avg_Sinfo -v hd=$human_avg_deltaS -v ls=$light_avg_Sinfo -v ld=$light_avg_deltaS \
+                                'BEGIN { printf "%.1f", (hs / hd) / (ls / ld) }')</p>
                         </div>
                     </div>
                 </div>
@@ -690,7 +603,7 @@ cat >> $HTML_FILE << EOF
             <p><strong>EXPERIMENTÁLNE OVERENÉ:</strong> $(date)</p>
             <p>Kybernautika v3.3 (Paralelná verzia) • Peter Leukanič • 2026</p>
             <p>Testované na svete ${WORLD_SIZE}×${WORLD_SIZE} (${WORLD_SIZE}² = $((WORLD_SIZE*WORLD_SIZE)) buniek)</p>
-            <p style="font-size: 0.9em; color: #666;">t-hodnota = ${t_value_deltaS} | p < 0.001 | n = ${REPETITIONS}</p>
+            <p style="font-size: 0.9em; color: #666;">t-hodnota = ${t_value_deltaS} | p = ${p_value_deltaS} | n = ${REPETITIONS}</p>
         </div>
     </div>
 </body>
@@ -708,8 +621,7 @@ echo "  • Entropická efektivita: +${improvement_deltaS}%"
 echo "  • Pomer optimalizácie: +${improvement_ratio}%"
 echo ""
 echo " ŠTATISTICKÁ VÝZNAMNOSŤ:"
-echo "  • t-hodnota: $t_value_deltaS (p < 0.001)"
-echo "  • Výsledky sú vysoko štatisticky významné"
+echo "  • t-hodnota: $t_value_deltaS (p = $p_value_deltaS)"
 echo ""
 echo " VÝSTUPNÉ SÚBORY:"
 echo "  • Logy testov: $OUTPUT_DIR/*.log"